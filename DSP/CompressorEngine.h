@@ -0,0 +1,1227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "CompressorStage.h"
+#include "Crossover.h"
+#include "DCBlocker.h"
+#include "FastMath.h"
+#include "Lookahead.h"
+#include "MeterFrame.h"
+#include "OutputStage.h"
+#include "SoftClipper.h"
+#include "StageProfiler.h"
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Parameter values in their natural units, as exposed by the plugin
+struct Parameters
+{
+    // Stage 1 (Leveler)
+    float threshold1 = -24.0f;
+    float ratio1 = 2.5f;
+    float attack1 = 15.0f;
+    float release1 = 200.0f;
+    float sidechainHPF1 = 80.0f;
+    CompressorStage::SidechainSlope sidechainSlope1 = CompressorStage::SidechainSlope::Off;
+
+    // Stage 2 (Peak Catcher)
+    bool dualStage = false;
+    float threshold2 = -12.0f;
+    float ratio2 = 8.0f;
+    float attack2 = 2.0f;
+    float release2 = 50.0f;
+    float sidechainHPF2 = 80.0f;
+    CompressorStage::SidechainSlope sidechainSlope2 = CompressorStage::SidechainSlope::Off;
+
+    // Multiband leveler: stage 1 runs once per band, on bands split here
+    float crossover1 = 120.0f;
+    float crossover2 = 1000.0f;
+    float crossover3 = 5000.0f;
+
+    // Global
+    float makeupDB = 0.0f;
+    bool autoMakeup = true;
+    float mixPercent = 100.0f;
+    float knee = 3.0f;
+    Topology topology = Topology::VCA; // stage 1 and its bands; the peak catcher is always VCA
+    LinkMode linkMode = LinkMode::Unlinked;
+    SoftClipper::Mode clipMode = SoftClipper::Mode::Fast;
+};
+
+// A parameter update that takes effect partway through a block
+struct ParameterChange
+{
+    int sampleOffset = 0;
+    Parameters parameters;
+};
+
+// What the engine did with a chunk of audio
+enum class ProcessingPath
+{
+    Full = 0,  // detector, gain computer and dry/wet crossfade
+    Silent,    // digital silence with decayed state: output left silent
+    DryOnly,   // mix at 0%: delayed dry signal, no compression
+    WetOnly,   // mix at 100%: no dry copy or crossfade
+    NumPaths
+};
+
+//==============================================================================
+// The complete dual-stage compressor: DC blocker, leveler, lookahead peak
+// catcher, makeup/mix and soft clipper. Has no dependency on JUCE; the plugin is a thin
+// adapter that feeds it parameters and host buffers.
+//
+// All memory is allocated in prepare(). process() accepts any block length and
+// splits it into chunks that fit the prepared storage. Parameter updates are
+// cheap: time constants are only recomputed when they change, and threshold,
+// ratio, knee and mix glide per sample. Hosts or tools that know where
+// automation points fall inside a block can pass them to process() to split
+// the block there.
+//
+// The peak catcher's lookahead delays the output, as does a linear phase
+// crossover. The delay is the same whether or not stage 2 is enabled, and the
+// dry signal is delayed to match, so getLatencySamples() only changes when
+// setLookahead() or setCrossover() is called.
+//
+// Channels are processed in lane groups of four, one SIMD lane per channel,
+// so up to maxChannels channels cost one pass per group. Linked modes share a
+// detector level across each link group, which may span lane groups and
+// leave channels (an LFE, say) on their own detector.
+//
+// In multiband mode the leveler's input is split into three or four bands.
+// Each channel gets its own CompressorStage whose lanes are that channel's
+// bands, so all bands of a channel are compressed in one pass; they share
+// stage 1's settings and are summed back before the peak catcher. Linked
+// modes link each band across the channels of a link group, as the full-band
+// detectors are, so a band compresses every channel of the group alike.
+//
+// Each chunk takes one of four paths. Silent input with fully decayed state
+// skips everything; a 0% mix passes the (latency-aligned) dry signal straight
+// to the clipper; a 100% mix skips the dry copy and crossfade. Whatever a
+// skipped path leaves stale is reset before it is used again, and the chunk
+// count of each path is kept for profiling.
+//
+// crossfadeToParameters() is for changing many settings at once, as a preset
+// does: instead of each gliding at its own pace, the gain computers switch
+// straight to the new settings and their output is crossfaded over
+// crossfadeMs. A peak catcher switched off keeps running until it has faded
+// out.
+//
+// Stage 1 and its bands run the topology in Parameters (VCA, FET, Opto or
+// Vari-Mu). The micro-block pipeline is compiled once per topology and
+// processWet() picks one per chunk, so no per-sample loop checks it.
+//
+// SampleType is float or double. Hosts with a 64-bit mix engine can run the
+// double version natively; Parameters, meter frames and the processing
+// path enum are shared by both.
+//==============================================================================
+template <typename SampleType>
+class BasicCompressorEngine
+{
+public:
+    static constexpr int maxChannels = 16;
+    static constexpr float maxLookaheadMs = 10.0f;
+    static constexpr double crossfadeMs = 5.0;
+
+    using Stage = BasicCompressorStage<SampleType>;
+    using CrossoverPhase = MixCompressorDSP::CrossoverPhase;
+    using ProcessingPath = MixCompressorDSP::ProcessingPath;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset() noexcept;
+    void setParameters(const Parameters& newParameters) noexcept;
+    void crossfadeToParameters(const Parameters& newParameters) noexcept;
+
+    // Lookahead of the peak catcher, clamped to maxLookaheadMs at the prepared rate
+    void setLookahead(int numSamples) noexcept;
+    int getLookahead() const noexcept { return lookahead; }
+    int getLatencySamples() const noexcept { return lookahead + crossoverLatency; }
+
+    // Splits stage 1 into numBands bands (3 or 4; anything else is off).
+    // Linear phase adds crossoverLatencySamples() of latency.
+    void setCrossover(int numBands, CrossoverPhase phase) noexcept;
+    int getNumBands() const noexcept { return numBands; }
+    CrossoverPhase getCrossoverPhase() const noexcept { return crossoverPhase; }
+
+    static int crossoverLatencySamples(int numBands, CrossoverPhase phase, double sampleRate) noexcept
+    {
+        return numBands >= 3 && phase == CrossoverPhase::Linear ? Crossover<CompressorStage::numLanes>::linearPhaseLatency(sampleRate) : 0;
+    }
+
+    // Which channels share a detector in the linked modes: channels with the
+    // same non-negative group number are linked, a negative number leaves the
+    // channel on its own. Until this is called every channel is in group 0.
+    void setLinkGroups(const int* groupOfChannel, int numChannels) noexcept;
+
+    static int lookaheadMsToSamples(float milliseconds, double sampleRate) noexcept
+    {
+        return static_cast<int>(std::lround(std::clamp(milliseconds, 0.0f, maxLookaheadMs) * 0.001 * sampleRate));
+    }
+
+    // Processes planar channel buffers in place
+    void process(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Same, applying each change (sorted by sampleOffset) at its position in the block
+    void process(SampleType* const* channels, int numChannels, int numSamples,
+        const ParameterChange* changes, int numChanges) noexcept;
+
+    // Peak gain reduction of the last process() call, always available
+    float getMaxGainReduction() const noexcept { return lastMaxGainReduction; }
+
+    // Detailed per-channel metering costs a few passes over the audio, so it is
+    // off until asked for. The frame describes the last process() call.
+    void setMeteringEnabled(bool shouldMeter) noexcept { meteringEnabled = shouldMeter; }
+    const MeterFrame& getMeterFrame() const noexcept { return meterFrame; }
+
+    // Instrumentation: how many chunks took each path. Safe to read from any thread.
+    std::uint64_t getPathCount(ProcessingPath path) const noexcept
+    {
+        return pathCounts[static_cast<int>(path)].load(std::memory_order_relaxed);
+    }
+
+    ProcessingPath getLastPath() const noexcept { return lastPath.load(std::memory_order_relaxed); }
+
+    void resetPathCounts() noexcept
+    {
+        for (auto& count : pathCounts)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+#if MIXCOMP_ENABLE_PROFILING
+    // Time per stage, for the caller to take after each process() call
+    StageProfiler& getProfiler() noexcept { return profiler; }
+#endif
+
+private:
+    //==============================================================================
+    struct LaneGroup;
+
+    void processSegment(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+    float processChunk(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+    ProcessingPath choosePath(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+    void settleForSilence() noexcept;
+    void processDryOnly(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+    float processWet(SampleType* const* channels, int numChannels, int startSample, int numSamples, bool mixWithDry) noexcept;
+
+    template <typename Topology>
+    float processMicroBlocks(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+
+    template <typename Topology>
+    float processMicroBlock(SampleType* const* channels, int numChannels, int startSample, int numFrames) noexcept;
+
+    void detectBands(LaneGroup& group, int firstChannel, int numChannels, int numFrames) noexcept;
+    template <typename Topology>
+    void compressBands(LaneGroup& group, int firstChannel, int numChannels, int numFrames) noexcept;
+    void linkDetectors(float* const* detectors, int numChannels, int numFrames) const noexcept;
+    void linkBandDetectors(int numChannels, int numFrames) noexcept;
+    template <typename LevelOf>
+    void linkLevels(int numChannels, int numFrames, LevelOf levelOf) const noexcept;
+    void updateLinkGroups() noexcept;
+    void resetBands() noexcept;
+
+    void beginMeterFrame(int numChannels, int numSamples) noexcept;
+    void endMeterFrame() noexcept;
+    void meterGainReduction(int stage, int firstChannel, const float* gainReduction, int numFrames) noexcept;
+    void meterRanges(int numGroups, int numFrames, bool includeStage2) noexcept;
+    static void meterLevels(const SampleType* const* channels, int numChannels, int startSample, int numSamples,
+        float* peaks, float* sumsOfSquares) noexcept;
+
+    //==============================================================================
+    static constexpr int numLanes = CompressorStage::numLanes;
+    static constexpr int maxLaneGroups = maxChannels / numLanes;
+    static constexpr int maxBands = Crossover<numLanes>::maxBands;
+
+    // Everything that runs on four channels at once, and the interleaved
+    // micro-block scratch it works in
+    struct LaneGroup
+    {
+        DCBlocker<numLanes, SampleType> dcBlocker;
+        Stage stage1; // Leveler
+        Stage stage2; // Peak catcher
+        Crossover<numLanes, SampleType> crossover;
+
+        alignas(16) SampleType frames[CompressorStage::maxBlockSamples] = {};
+        alignas(16) float stage1GR[CompressorStage::maxBlockSamples] = {};
+        alignas(16) float stage2GR[CompressorStage::maxBlockSamples] = {};
+        alignas(16) float detectorEnvelope[CompressorStage::maxBlockSamples] = {};
+    };
+
+    Parameters parameters;
+
+    // Sized for the prepared channel count
+    std::vector<LaneGroup> laneGroups;
+
+    // Multiband leveler: one stage per channel, one lane per band
+    std::vector<Stage> bandStages;
+    int numBands = 1;
+    CrossoverPhase crossoverPhase = CrossoverPhase::Minimum;
+    int crossoverLatency = 0;
+
+    OutputStage outputStage;
+    SoftClipper softClipper;
+
+    // Dry copy of each channel for parallel processing
+    std::vector<SampleType> dryStorage;
+    const SampleType* dryChannels[maxChannels] = {};
+    SampleType* dryChannelsWritable[maxChannels] = {};
+    std::vector<FrameDelay<1, SampleType>> dryDelays;
+    int preparedChannels = 0;
+    int maxChunkSize = 0;
+    double sampleRate = 44100.0;
+
+    int lookahead = 0;
+    int maxLookahead = 0;
+
+    // Link groups, as channel indices listed group by group
+    int linkGroupOf[maxChannels] = {};
+    int linkedChannels[maxChannels] = {};
+    int linkGroupEnds[maxChannels] = {};
+    int numLinkGroups = 0;
+
+    // Band scratch. The crossover output is shared by all lane groups; each
+    // channel keeps its bands between detection and compression, so links
+    // can see every channel's detector first.
+    alignas(16) SampleType bandBuffers[maxBands][CompressorStage::maxBlockSamples] = {};
+    alignas(16) SampleType bandFrames[maxChannels][CompressorStage::maxBlockSamples] = {};
+    alignas(16) float bandGR[CompressorStage::maxBlockSamples] = {};
+    alignas(16) float bandEnvelope[CompressorStage::maxBlockSamples] = {};
+
+    float lastMaxGainReduction = 0.0f;
+
+    // Metering
+    bool meteringEnabled = false;
+    MeterFrame meterFrame;
+    float inputSumOfSquares[maxChannels] = {};
+    float outputSumOfSquares[maxChannels] = {};
+    float detectorMin = 0.0f, detectorMax = 0.0f; // linear, over the frame so far
+    float minGainReduction = 0.0f;
+    std::int64_t samplePosition = 0;
+
+    static_assert(MeterFrame::maxChannels >= maxChannels, "MeterFrame must hold every channel");
+    static_assert(MeterFrame::maxBands >= maxBands, "MeterFrame must hold every band");
+    static_assert(maxBands <= CompressorStage::numLanes, "every band needs a lane");
+    static_assert(maxChannels % numLanes == 0, "lane groups must cover every channel");
+
+    // Fast-path bookkeeping
+    int silentSamples = 0;        // consecutive samples of digital silence at the input
+    bool settled = false;         // state has been reset for silence
+    bool wetPathStale = false;    // detector skipped while the mix was at 0%
+    bool dryPathStale = false;    // dry delay skipped while the mix was at 100%
+    int stage2FadeOutFrames = 0;  // peak catcher still running after being switched off
+
+    // Envelope and filter levels below this count as decayed: more than 30 dB
+    // under the lowest threshold and knee, so resetting them changes nothing
+    static constexpr float settledLevel = 1.0e-5f;
+
+    std::atomic<std::uint64_t> pathCounts[static_cast<int>(ProcessingPath::NumPaths)] = {};
+    std::atomic<ProcessingPath> lastPath{ ProcessingPath::Full };
+
+#if MIXCOMP_ENABLE_PROFILING
+    StageProfiler profiler;
+#endif
+};
+
+//==============================================================================
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::prepare(double newSampleRate, int maxBlockSize, int numChannels)
+{
+    sampleRate = newSampleRate;
+    preparedChannels = std::clamp(numChannels, 0, maxChannels);
+    maxChunkSize = std::max(1, maxBlockSize);
+    maxLookahead = lookaheadMsToSamples(maxLookaheadMs, sampleRate);
+
+    // Fresh state for every channel; the layouts and settings are applied below
+    auto numGroups = (preparedChannels + numLanes - 1) / numLanes;
+    laneGroups.clear();
+    laneGroups.resize(static_cast<size_t>(numGroups));
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        auto& group = laneGroups[static_cast<size_t>(g)];
+        group.dcBlocker.prepare(sampleRate);
+        group.stage1.prepare(sampleRate);
+        group.stage2.prepare(sampleRate, maxLookahead);
+        group.crossover.prepare(sampleRate);
+        group.crossover.setNumActiveLanes(preparedChannels - g * numLanes);
+        group.crossover.setLayout(numBands, crossoverPhase);
+    }
+
+    bandStages.clear();
+    bandStages.resize(static_cast<size_t>(preparedChannels));
+
+    for (auto& stage : bandStages)
+        stage.prepare(sampleRate);
+
+    crossoverLatency = crossoverLatencySamples(numBands, crossoverPhase, sampleRate);
+
+    auto maxLatency = maxLookahead + Crossover<numLanes>::linearPhaseLatency(sampleRate);
+    outputStage.prepare(sampleRate, maxChunkSize);
+    softClipper.prepare(preparedChannels);
+
+    dryStorage.assign(static_cast<size_t>(preparedChannels * maxChunkSize), 0.0f);
+    dryDelays.assign(static_cast<size_t>(preparedChannels), FrameDelay<1, SampleType>{});
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        auto* data = channel < preparedChannels ? dryStorage.data() + channel * maxChunkSize : nullptr;
+        dryChannelsWritable[channel] = data;
+        dryChannels[channel] = data;
+    }
+
+    for (auto& delay : dryDelays)
+        delay.prepare(maxLatency);
+
+    updateLinkGroups();
+    setLookahead(lookahead);
+    setParameters(parameters);
+    reset();
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::reset() noexcept
+{
+    for (auto& group : laneGroups)
+    {
+        group.dcBlocker.reset();
+        group.stage1.reset();
+        group.stage2.reset();
+    }
+
+    resetBands();
+    outputStage.reset();
+    softClipper.reset();
+
+    for (auto& delay : dryDelays)
+        delay.reset();
+
+    lastMaxGainReduction = 0.0f;
+    meterFrame = {};
+    samplePosition = 0;
+
+    silentSamples = 0;
+    settled = false;
+    wetPathStale = false;
+    dryPathStale = false;
+    stage2FadeOutFrames = 0;
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::setParameters(const Parameters& newParameters) noexcept
+{
+    parameters = newParameters;
+
+    // The lane group stages stay unlinked; linkDetectors() links across groups
+    for (auto& group : laneGroups)
+    {
+        group.stage1.setParameters(parameters.threshold1, parameters.ratio1, parameters.attack1, parameters.release1, parameters.knee);
+        group.stage2.setParameters(parameters.threshold2, parameters.ratio2, parameters.attack2, parameters.release2, parameters.knee);
+        group.stage1.setSidechainFilter(parameters.sidechainHPF1, parameters.sidechainSlope1);
+        group.stage2.setSidechainFilter(parameters.sidechainHPF2, parameters.sidechainSlope2);
+        group.crossover.setFrequencies(parameters.crossover1, parameters.crossover2, parameters.crossover3);
+    }
+
+    // Band stages link nothing themselves: their lanes are bands, not
+    // channels; linkBandDetectors() links each band across channels
+    for (auto& stage : bandStages)
+    {
+        stage.setParameters(parameters.threshold1, parameters.ratio1, parameters.attack1, parameters.release1, parameters.knee);
+        stage.setLinkMode(LinkMode::Unlinked, numBands);
+    }
+
+    outputStage.setMix(parameters.mixPercent);
+    softClipper.setMode(parameters.clipMode);
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::crossfadeToParameters(const Parameters& newParameters) noexcept
+{
+    using Crossfade = typename Stage::Crossfade;
+
+    auto wasDualStage = parameters.dualStage;
+    auto fadingOut = stage2FadeOutFrames > 0;
+    setParameters(newParameters);
+
+    auto numFrames = static_cast<int>(std::lround(crossfadeMs * 0.001 * sampleRate));
+
+    for (auto& group : laneGroups)
+    {
+        group.stage1.beginCrossfade(numFrames);
+
+        // A peak catcher already fading out is left to finish
+        if (parameters.dualStage)
+            group.stage2.beginCrossfade(numFrames, wasDualStage || fadingOut ? Crossfade::Settings : Crossfade::FadeIn);
+        else if (wasDualStage)
+            group.stage2.beginCrossfade(numFrames, Crossfade::FadeOut);
+    }
+
+    for (auto& stage : bandStages)
+        stage.beginCrossfade(numFrames);
+
+    if (parameters.dualStage)
+        stage2FadeOutFrames = 0;
+    else if (wasDualStage)
+        stage2FadeOutFrames = numFrames;
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::setLookahead(int numSamples) noexcept
+{
+    lookahead = std::clamp(numSamples, 0, maxLookahead);
+
+    for (auto& group : laneGroups)
+        group.stage2.setLookahead(lookahead);
+
+    for (auto& delay : dryDelays)
+        delay.setDelay(getLatencySamples());
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::setCrossover(int newNumBands, CrossoverPhase phase) noexcept
+{
+    newNumBands = newNumBands >= 3 ? std::min(newNumBands, maxBands) : 1;
+
+    if (newNumBands == numBands && phase == crossoverPhase)
+        return;
+
+    numBands = newNumBands;
+    crossoverPhase = phase;
+    crossoverLatency = crossoverLatencySamples(numBands, crossoverPhase, sampleRate);
+
+    for (auto& group : laneGroups)
+        group.crossover.setLayout(numBands, crossoverPhase);
+
+    resetBands();
+    setParameters(parameters);
+
+    for (auto& delay : dryDelays)
+        delay.setDelay(getLatencySamples());
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::resetBands() noexcept
+{
+    for (auto& group : laneGroups)
+        group.crossover.reset();
+
+    for (auto& stage : bandStages)
+        stage.reset();
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::setLinkGroups(const int* groupOfChannel, int numChannels) noexcept
+{
+    for (int channel = 0; channel < maxChannels; ++channel)
+        linkGroupOf[channel] = channel < numChannels ? groupOfChannel[channel] : 0;
+
+    updateLinkGroups();
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::updateLinkGroups() noexcept
+{
+    // List the prepared channels group by group, in group number order;
+    // groups of one channel have nothing to link and are left out
+    numLinkGroups = 0;
+    int numLinked = 0;
+    int previous = -1;
+
+    for (;;)
+    {
+        int next = std::numeric_limits<int>::max();
+
+        for (int channel = 0; channel < preparedChannels; ++channel)
+            if (linkGroupOf[channel] > previous)
+                next = std::min(next, linkGroupOf[channel]);
+
+        if (next == std::numeric_limits<int>::max())
+            break;
+
+        auto start = numLinked;
+
+        for (int channel = 0; channel < preparedChannels; ++channel)
+            if (linkGroupOf[channel] == next)
+                linkedChannels[numLinked++] = channel;
+
+        if (numLinked - start > 1)
+            linkGroupEnds[numLinkGroups++] = numLinked;
+        else
+            numLinked = start;
+
+        previous = next;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    process(channels, numChannels, numSamples, nullptr, 0);
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples,
+    const ParameterChange* changes, int numChanges) noexcept
+{
+    numChannels = std::min(numChannels, preparedChannels);
+    lastMaxGainReduction = 0.0f;
+
+    if (meteringEnabled)
+        beginMeterFrame(numChannels, numSamples);
+
+    samplePosition += numSamples;
+
+    if (numChannels <= 0)
+        return;
+
+    // Split the block at each automation point
+    int position = 0;
+
+    for (int i = 0; i < numChanges; ++i)
+    {
+        auto changeAt = std::clamp(changes[i].sampleOffset, position, numSamples);
+        processSegment(channels, numChannels, position, changeAt - position);
+
+        setParameters(changes[i].parameters);
+        position = changeAt;
+    }
+
+    processSegment(channels, numChannels, position, numSamples - position);
+
+    if (meteringEnabled)
+        endMeterFrame();
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::processSegment(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    // Hosts may send more samples than prepare() announced.
+    // Rather than growing the dry buffer here, process in chunks that fit it.
+    for (int offset = 0; offset < numSamples; offset += maxChunkSize)
+    {
+        auto num = std::min(maxChunkSize, numSamples - offset);
+        lastMaxGainReduction = std::max(lastMaxGainReduction, processChunk(channels, numChannels, startSample + offset, num));
+    }
+}
+
+template <typename SampleType>
+inline float BasicCompressorEngine<SampleType>::processChunk(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    auto path = choosePath(channels, numChannels, startSample, numSamples);
+    pathCounts[static_cast<int>(path)].fetch_add(1, std::memory_order_relaxed);
+    lastPath.store(path, std::memory_order_relaxed);
+
+    // Neither of these runs the detector: no gain reduction, nothing detected
+    if (meteringEnabled && (path == ProcessingPath::Silent || path == ProcessingPath::DryOnly))
+    {
+        detectorMin = 0.0f;
+        minGainReduction = 0.0f;
+    }
+
+    if (path == ProcessingPath::Silent)
+    {
+        // The input is all zeros, so the buffer already holds the output and
+        // the meters have nothing to add
+        settleForSilence();
+        return 0.0f;
+    }
+
+    if (meteringEnabled)
+        meterLevels(channels, numChannels, startSample, numSamples, meterFrame.inputPeak, inputSumOfSquares);
+
+    settled = false;
+
+    if (path == ProcessingPath::DryOnly)
+    {
+        processDryOnly(channels, numChannels, startSample, numSamples);
+        return 0.0f;
+    }
+
+    return processWet(channels, numChannels, startSample, numSamples, path == ProcessingPath::Full);
+}
+
+template <typename SampleType>
+inline ProcessingPath BasicCompressorEngine<SampleType>::choosePath(SampleType* const* channels, int numChannels,
+    int startSample, int numSamples) noexcept
+{
+    bool inputSilent = true;
+
+    for (int channel = 0; channel < numChannels && inputSilent; ++channel)
+        inputSilent = FastMath::peak(channels[channel] + startSample, numSamples) == 0.0f;
+
+    // The delay lines only hold silence once a full lookahead of it has gone
+    // in; a linear phase filter's history is twice its latency
+    auto delaysSilent = silentSamples >= getLatencySamples() + crossoverLatency;
+    silentSamples = inputSilent ? std::min(silentSamples + numSamples, 1 << 30) : 0;
+
+    if (inputSilent && delaysSilent)
+    {
+        auto decayed = settled;
+
+        if (!decayed)
+        {
+            decayed = true;
+
+            for (auto& group : laneGroups)
+                decayed = decayed && group.dcBlocker.isSettled(settledLevel) && group.stage1.isSettled(settledLevel)
+                    && (!parameters.dualStage || group.stage2.isSettled(settledLevel));
+
+            if (numBands > 1)
+                for (auto& stage : bandStages)
+                    decayed = decayed && stage.isSettled(settledLevel);
+        }
+
+        if (decayed)
+            return ProcessingPath::Silent;
+    }
+
+    if (outputStage.isFullyDry())
+        return ProcessingPath::DryOnly;
+
+    if (outputStage.isFullyWet())
+        return ProcessingPath::WetOnly;
+
+    return ProcessingPath::Full;
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::settleForSilence() noexcept
+{
+    if (settled)
+        return;
+
+    // Put everything where the full path would have decayed to, so the first
+    // block after the silence starts from the same state
+    for (auto& group : laneGroups)
+    {
+        group.dcBlocker.reset();
+        group.stage1.reset();
+        group.stage2.reset();
+    }
+
+    resetBands();
+    softClipper.reset();
+    stage2FadeOutFrames = 0;
+
+    for (auto& delay : dryDelays)
+        delay.reset();
+
+    outputStage.setMakeupGain(FastMath::decibelsToGain(parameters.makeupDB));
+    outputStage.reset();
+
+    settled = true;
+    wetPathStale = false;
+    dryPathStale = false;
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::processDryOnly(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    // Same output as the crossfade at 0%: the dry signal, delayed to the
+    // reported latency, through the clipper
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = channels[channel] + startSample;
+
+        MIXCOMP_PROFILE_BEGIN(MakeupMix);
+        dryDelays[channel].process(data, numSamples);
+        MIXCOMP_PROFILE_END(profiler, MakeupMix);
+
+        MIXCOMP_PROFILE_BEGIN(SoftClip);
+        softClipper.process(data, channel, numSamples);
+        MIXCOMP_PROFILE_END(profiler, SoftClip);
+    }
+
+    if (meteringEnabled)
+        meterLevels(channels, numChannels, startSample, numSamples, meterFrame.outputPeak, outputSumOfSquares);
+
+    // The detector hasn't seen this audio; start it afresh when the mix comes
+    // back up (the wet signal fades in from silence anyway)
+    wetPathStale = true;
+}
+
+template <typename SampleType>
+inline float BasicCompressorEngine<SampleType>::processWet(SampleType* const* channels, int numChannels, int startSample, int numSamples, bool mixWithDry) noexcept
+{
+    if (wetPathStale)
+    {
+        for (auto& group : laneGroups)
+        {
+            group.dcBlocker.reset();
+            group.stage1.reset();
+            group.stage2.reset();
+        }
+
+        resetBands();
+        stage2FadeOutFrames = 0;
+        wetPathStale = false;
+    }
+
+    if (mixWithDry)
+    {
+        // The dry delay missed the audio of a fully wet stretch; the dry signal
+        // fades in from silence, so clear it rather than replay old audio
+        if (dryPathStale)
+        {
+            for (auto& delay : dryDelays)
+                delay.reset();
+
+            dryPathStale = false;
+        }
+
+        // Keep a copy of the dry signal for parallel processing, delayed to line up
+        // with the lookahead of the wet path
+        MIXCOMP_PROFILE_BEGIN(MakeupMix);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            std::copy(channels[channel] + startSample, channels[channel] + startSample + numSamples, dryChannelsWritable[channel]);
+            dryDelays[channel].process(dryChannelsWritable[channel], numSamples);
+        }
+
+        MIXCOMP_PROFILE_END(profiler, MakeupMix);
+    }
+    else
+    {
+        dryPathStale = true;
+    }
+
+    // The topology is picked here, once per chunk; everything below is
+    // compiled separately for each
+    float maxGR = 0.0f;
+
+    switch (parameters.topology)
+    {
+    case Topology::FET:    maxGR = processMicroBlocks<Topologies::FET>(channels, numChannels, startSample, numSamples); break;
+    case Topology::Opto:   maxGR = processMicroBlocks<Topologies::Opto>(channels, numChannels, startSample, numSamples); break;
+    case Topology::VariMu: maxGR = processMicroBlocks<Topologies::VariMu>(channels, numChannels, startSample, numSamples); break;
+    case Topology::VCA:
+    default:               maxGR = processMicroBlocks<Topologies::VCA>(channels, numChannels, startSample, numSamples); break;
+    }
+
+    // Calculate and smooth makeup gain
+    MIXCOMP_PROFILE_BEGIN(MakeupMix);
+    float targetMakeupDB = parameters.makeupDB;
+
+    if (parameters.autoMakeup && maxGR > 0.01f)
+        targetMakeupDB = OutputStage::calculateAutoMakeup(maxGR);
+
+    outputStage.setMakeupGain(FastMath::decibelsToGain(targetMakeupDB));
+
+    // Apply mix (parallel compression) with smoothed makeup gain, then soft clip
+    SampleType* wet[maxChannels] = {};
+    for (int channel = 0; channel < numChannels; ++channel)
+        wet[channel] = channels[channel] + startSample;
+
+    if (mixWithDry)
+        outputStage.process(wet, dryChannels, numChannels, numSamples);
+    else
+        outputStage.processWet(wet, numChannels, numSamples);
+
+    MIXCOMP_PROFILE_END(profiler, MakeupMix);
+
+    MIXCOMP_PROFILE_BEGIN(SoftClip);
+    for (int channel = 0; channel < numChannels; ++channel)
+        softClipper.process(wet[channel], channel, numSamples);
+    MIXCOMP_PROFILE_END(profiler, SoftClip);
+
+    if (meteringEnabled)
+        meterLevels(channels, numChannels, startSample, numSamples, meterFrame.outputPeak, outputSumOfSquares);
+
+    return maxGR;
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline float BasicCompressorEngine<SampleType>::processMicroBlocks(SampleType* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    float maxGR = 0.0f;
+
+    // Run the pipeline over micro-blocks that fit in L1
+    for (int blockStart = 0; blockStart < numSamples; blockStart += CompressorStage::maxBlockFrames)
+    {
+        auto numFrames = std::min(CompressorStage::maxBlockFrames, numSamples - blockStart);
+        maxGR = std::max(maxGR, processMicroBlock<Topology>(channels, numChannels, startSample + blockStart, numFrames));
+    }
+
+    return maxGR;
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline float BasicCompressorEngine<SampleType>::processMicroBlock(SampleType* const* channels, int numChannels, int startSample, int numFrames) noexcept
+{
+    auto numBlockSamples = numFrames * numLanes;
+    auto numGroups = (numChannels + numLanes - 1) / numLanes;
+    auto linked = parameters.linkMode != LinkMode::Unlinked && numLinkGroups > 0;
+    float* detectors[maxLaneGroups] = {};
+
+    // Interleave four channels per lane group; unused lanes are zeroed and processed alongside for free
+    for (int g = 0; g < numGroups; ++g)
+    {
+        auto& group = laneGroups[static_cast<size_t>(g)];
+        auto firstChannel = g * numLanes;
+        auto groupChannels = std::min(numLanes, numChannels - firstChannel);
+
+        for (int i = 0; i < numFrames; ++i)
+            for (int lane = 0; lane < numLanes; ++lane)
+                group.frames[i * numLanes + lane] = lane < groupChannels ? channels[firstChannel + lane][startSample + i] : 0.0f;
+
+        MIXCOMP_PROFILE_BEGIN(DCBlocker);
+        group.dcBlocker.process(group.frames, numFrames);
+        MIXCOMP_PROFILE_END(profiler, DCBlocker);
+    }
+
+    // Stage 1: Leveler, full band or split into bands. Links have to see
+    // every group's detector before any group's envelope moves on.
+    MIXCOMP_PROFILE_BEGIN(Stage1);
+
+    if (numBands > 1)
+    {
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto firstChannel = g * numLanes;
+            detectBands(laneGroups[static_cast<size_t>(g)], firstChannel, std::min(numLanes, numChannels - firstChannel), numFrames);
+        }
+
+        if (linked)
+            linkBandDetectors(numChannels, numFrames);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto firstChannel = g * numLanes;
+            compressBands<Topology>(laneGroups[static_cast<size_t>(g)], firstChannel, std::min(numLanes, numChannels - firstChannel), numFrames);
+        }
+    }
+    else
+    {
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+            group.stage1.detect(group.frames, numFrames);
+            detectors[g] = group.stage1.getDetector();
+        }
+
+        if (linked)
+            linkDetectors(detectors, numChannels, numFrames);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+            group.stage1.template compress<Topology>(group.frames, group.stage1GR, numFrames, meteringEnabled ? group.detectorEnvelope : nullptr);
+        }
+    }
+
+    MIXCOMP_PROFILE_END(profiler, Stage1);
+
+    // Stage 2: Peak Catcher (if enabled, or still fading out); otherwise
+    // still run the lookahead delay so the latency doesn't change
+    MIXCOMP_PROFILE_BEGIN(Stage2);
+
+    if (parameters.dualStage || stage2FadeOutFrames > 0)
+    {
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+            group.stage2.detect(group.frames, numFrames);
+            detectors[g] = group.stage2.getDetector();
+        }
+
+        if (linked)
+            linkDetectors(detectors, numChannels, numFrames);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+            group.stage2.compress(group.frames, group.stage2GR, numFrames);
+        }
+
+        stage2FadeOutFrames = std::max(0, stage2FadeOutFrames - numFrames);
+    }
+    else
+    {
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+            group.stage2.processBypassed(group.frames, numFrames);
+        }
+    }
+
+    MIXCOMP_PROFILE_END(profiler, Stage2);
+
+    float maxGR = 0.0f;
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        auto& group = laneGroups[static_cast<size_t>(g)];
+        auto firstChannel = g * numLanes;
+        auto groupChannels = std::min(numLanes, numChannels - firstChannel);
+
+        if (parameters.dualStage)
+        {
+            for (int i = 0; i < numBlockSamples; ++i)
+                maxGR = std::max(maxGR, group.stage1GR[i] + group.stage2GR[i]);
+        }
+        else
+        {
+            for (int i = 0; i < numBlockSamples; ++i)
+                maxGR = std::max(maxGR, group.stage1GR[i]);
+        }
+
+        if (meteringEnabled)
+        {
+            meterGainReduction(0, firstChannel, group.stage1GR, numFrames);
+
+            if (parameters.dualStage)
+                meterGainReduction(1, firstChannel, group.stage2GR, numFrames);
+        }
+
+        // De-interleave back into the host buffer
+        for (int i = 0; i < numFrames; ++i)
+            for (int lane = 0; lane < groupChannels; ++lane)
+                channels[firstChannel + lane][startSample + i] = group.frames[i * numLanes + lane];
+    }
+
+    if (meteringEnabled)
+        meterRanges(numGroups, numFrames, parameters.dualStage);
+
+    return maxGR;
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::linkDetectors(float* const* detectors, int numChannels, int numFrames) const noexcept
+{
+    linkLevels(numChannels, numFrames, [detectors](int channel, int frame) -> float&
+        {
+            return detectors[channel / numLanes][frame * numLanes + channel % numLanes];
+        });
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::linkBandDetectors(int numChannels, int numFrames) noexcept
+{
+    // Band by band: each band stage's lanes are its channel's bands
+    for (int band = 0; band < numBands; ++band)
+    {
+        linkLevels(numChannels, numFrames, [this, band](int channel, int frame) -> float&
+            {
+                return bandStages[static_cast<size_t>(channel)].getDetector()[frame * numLanes + band];
+            });
+    }
+}
+
+template <typename SampleType>
+template <typename LevelOf>
+inline void BasicCompressorEngine<SampleType>::linkLevels(int numChannels, int numFrames, LevelOf levelOf) const noexcept
+{
+    // Each link group shares one level per frame: its loudest channel's, or
+    // the mean of them all. Channels this block doesn't carry are left out.
+    auto average = parameters.linkMode == LinkMode::LinkedAverage;
+    int start = 0;
+
+    for (int group = 0; group < numLinkGroups; ++group)
+    {
+        auto end = linkGroupEnds[group];
+        int numPresent = 0;
+
+        for (int i = start; i < end; ++i)
+            numPresent += linkedChannels[i] < numChannels ? 1 : 0;
+
+        if (numPresent > 1)
+        {
+            auto inverseSize = 1.0f / static_cast<float>(numPresent);
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                float linked = 0.0f;
+
+                for (int i = start; i < end; ++i)
+                {
+                    if (linkedChannels[i] < numChannels)
+                    {
+                        auto level = levelOf(linkedChannels[i], frame);
+                        linked = average ? linked + level : std::max(linked, level);
+                    }
+                }
+
+                if (average)
+                    linked *= inverseSize;
+
+                for (int i = start; i < end; ++i)
+                    if (linkedChannels[i] < numChannels)
+                        levelOf(linkedChannels[i], frame) = linked;
+            }
+        }
+
+        start = end;
+    }
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::detectBands(LaneGroup& group, int firstChannel, int numChannels, int numFrames) noexcept
+{
+    SampleType* bands[maxBands] = { bandBuffers[0], bandBuffers[1], bandBuffers[2], bandBuffers[3] };
+    group.crossover.process(group.frames, bands, numFrames);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        // The bands of this channel become the lanes of its own stage
+        auto* frames = bandFrames[firstChannel + channel];
+
+        for (int i = 0; i < numFrames; ++i)
+            for (int band = 0; band < numLanes; ++band)
+                frames[i * numLanes + band] = band < numBands ? bands[band][i * numLanes + channel] : 0.0f;
+
+        bandStages[static_cast<size_t>(firstChannel + channel)].detect(frames, numFrames);
+    }
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline void BasicCompressorEngine<SampleType>::compressBands(LaneGroup& group, int firstChannel, int numChannels, int numFrames) noexcept
+{
+    auto numBlockSamples = numFrames * numLanes;
+    auto* frames = group.frames;
+    auto* stage1GR = group.stage1GR;
+    auto* detectorEnvelope = group.detectorEnvelope;
+
+    std::fill(stage1GR, stage1GR + numBlockSamples, 0.0f);
+    std::fill(detectorEnvelope, detectorEnvelope + numBlockSamples, 0.0f);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelBands = bandFrames[firstChannel + channel];
+
+        bandStages[static_cast<size_t>(firstChannel + channel)].template compress<Topology>(channelBands, bandGR, numFrames,
+            meteringEnabled ? bandEnvelope : nullptr);
+
+        // Sum the bands back into the channel; the most compressed band
+        // stands for the channel on the meters and for auto makeup
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = channelBands + i * numLanes;
+            auto* gainReduction = bandGR + i * numLanes;
+
+            frames[i * numLanes + channel] = (frame[0] + frame[1]) + (frame[2] + frame[3]);
+            stage1GR[i * numLanes + channel] = std::max(std::max(gainReduction[0], gainReduction[1]),
+                std::max(gainReduction[2], gainReduction[3]));
+        }
+
+        if (meteringEnabled)
+        {
+            for (int i = 0; i < numFrames; ++i)
+                for (int band = 0; band < numBands; ++band)
+                {
+                    auto index = i * numLanes + band;
+                    meterFrame.bandGainReduction[band] = std::max(meterFrame.bandGainReduction[band], bandGR[index]);
+                    detectorEnvelope[i * numLanes + channel] = std::max(detectorEnvelope[i * numLanes + channel], bandEnvelope[index]);
+                }
+        }
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::beginMeterFrame(int numChannels, int numSamples) noexcept
+{
+    meterFrame = {};
+    meterFrame.timestamp = samplePosition;
+    meterFrame.numChannels = std::max(0, numChannels);
+    meterFrame.numSamples = numSamples;
+    meterFrame.numBands = numBands > 1 ? numBands : 0;
+
+    std::fill(std::begin(inputSumOfSquares), std::end(inputSumOfSquares), 0.0f);
+    std::fill(std::begin(outputSumOfSquares), std::end(outputSumOfSquares), 0.0f);
+
+    // Empty ranges; blocks that skip the detector leave them that way
+    detectorMin = std::numeric_limits<float>::max();
+    detectorMax = 0.0f;
+    minGainReduction = std::numeric_limits<float>::max();
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::endMeterFrame() noexcept
+{
+    meterFrame.totalGainReduction = lastMaxGainReduction;
+    meterFrame.minGainReduction = std::min(minGainReduction, lastMaxGainReduction);
+
+    if (detectorMin > detectorMax)
+        detectorMin = detectorMax = 0.0f;
+
+    meterFrame.detectorMinDB = FastMath::gainToDecibels(detectorMin + 1e-6f);
+    meterFrame.detectorMaxDB = FastMath::gainToDecibels(detectorMax + 1e-6f);
+
+    if (meterFrame.numSamples <= 0)
+        return;
+
+    auto inverseLength = 1.0f / static_cast<float>(meterFrame.numSamples);
+
+    for (int channel = 0; channel < meterFrame.numChannels; ++channel)
+    {
+        meterFrame.inputRMS[channel] = std::sqrt(inputSumOfSquares[channel] * inverseLength);
+        meterFrame.outputRMS[channel] = std::sqrt(outputSumOfSquares[channel] * inverseLength);
+    }
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::meterGainReduction(int stage, int firstChannel, const float* gainReduction, int numFrames) noexcept
+{
+    auto* peaks = meterFrame.gainReduction[stage] + firstChannel;
+
+    for (int frame = 0; frame < numFrames; ++frame)
+        for (int lane = 0; lane < numLanes; ++lane)
+            peaks[lane] = std::max(peaks[lane], gainReduction[frame * numLanes + lane]);
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::meterRanges(int numGroups, int numFrames, bool includeStage2) noexcept
+{
+    // Per frame, the loudest channel drives the display, as on the bar meter;
+    // unused lanes hold zeros and never win
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        float level = 0.0f;
+        float gainReduction = 0.0f;
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = laneGroups[static_cast<size_t>(g)];
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto i = frame * numLanes + lane;
+                level = std::max(level, group.detectorEnvelope[i]);
+                gainReduction = std::max(gainReduction, group.stage1GR[i] + (includeStage2 ? group.stage2GR[i] : 0.0f));
+            }
+        }
+
+        detectorMin = std::min(detectorMin, level);
+        detectorMax = std::max(detectorMax, level);
+        minGainReduction = std::min(minGainReduction, gainReduction);
+    }
+}
+
+template <typename SampleType>
+inline void BasicCompressorEngine<SampleType>::meterLevels(const SampleType* const* channels, int numChannels, int startSample, int numSamples,
+    float* peaks, float* sumsOfSquares) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = channels[channel] + startSample;
+        SampleType sum = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+            sum += data[i] * data[i];
+
+        peaks[channel] = std::max(peaks[channel], static_cast<float>(FastMath::peak(data, numSamples)));
+        sumsOfSquares[channel] += static_cast<float>(sum);
+    }
+}
+
+//==============================================================================
+using CompressorEngine = BasicCompressorEngine<float>;
+}
@@ -0,0 +1,849 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "FastMath.h"
+#include "LinearRamp.h"
+#include "Lookahead.h"
+#include "SidechainFilter.h"
+#include "Topology.h"
+
+namespace MixCompressorDSP
+{
+// How the lanes of a stage (or the channels of an engine) share a detector
+enum class LinkMode
+{
+    Unlinked = 0,  // each channel has its own detector
+    LinkedMax,     // loudest channel drives all lanes
+    LinkedAverage  // mean level drives all lanes
+};
+
+//==============================================================================
+// Compressor engine - one lane per channel, structure-of-arrays layout.
+//
+// Audio is processed in micro-blocks of interleaved frames: sample i of lane l
+// lives at frames[i * numLanes + l]. Each step of the detector/gain computer
+// writes into a contiguous scratch array that stays in L1. The stateless steps
+// (rectify, gain computer, apply) run over the whole micro-block and vectorize;
+// only the envelope and gain-smoothing recursions walk the frames in order, and
+// even those process all lanes of a frame at once.
+//
+// SampleType is the type of the audio passing through. The detector and gain
+// computer work in float whatever it is, but the envelope and its
+// coefficients are double: at 192 kHz and above, long release coefficients
+// are too small for float to follow accurately.
+//
+// processBlock() and compress() take the topology (see Topology.h) as a
+// template argument and default to the clean VCA one. A stage can switch
+// topology between blocks; its envelope is carried over into the new one's
+// domain.
+//==============================================================================
+template <typename SampleType>
+class BasicCompressorStage
+{
+public:
+    static constexpr int numLanes = 4;        // one 128-bit register of floats
+    static constexpr int maxBlockFrames = 64; // 1 KB per scratch array
+    static constexpr int maxBlockSamples = maxBlockFrames * numLanes;
+
+    using LinkMode = MixCompressorDSP::LinkMode;
+    using SidechainSlope = typename SidechainFilter<numLanes>::Slope;
+
+    enum class Crossfade
+    {
+        Settings = 0, // from the gain applied so far to the new settings' gain
+        FadeIn,       // from unity, for a stage being switched on
+        FadeOut       // to unity, for a stage being switched off
+    };
+
+    // maxLookaheadFrames sizes the lookahead delay; leave it at zero for stages
+    // that never look ahead
+    void prepare(double sampleRate, int maxLookaheadFrames = 0);
+
+    // Threshold, ratio and knee glide to new values per sample. The attack
+    // coefficient is only recomputed when the time actually changes; a new
+    // release time (e.g. a tempo-synced one after a tempo change) glides in
+    // too, with its coefficients updated once per block while it does.
+    void setParameters(float threshold, float ratio, float attack, float release, float knee);
+    void setLinkMode(LinkMode mode, int numActiveLanes);
+
+    // Moves threshold, ratio, knee and release straight to the values last
+    // set, and crossfades the applied gain into theirs over numFrames, so a
+    // whole new set of settings lands at once without a click
+    void beginCrossfade(int numFrames, Crossfade type = Crossfade::Settings) noexcept;
+
+    // High-passes what the detector hears, not the audio
+    void setSidechainFilter(float frequencyHz, SidechainSlope filterSlope) noexcept
+    {
+        sidechainFilter.setParameters(frequencyHz, filterSlope);
+    }
+
+    // Delays the audio by numFrames and lets the detector see the loudest peak
+    // of the frames in between, so gain reduction is in place before a
+    // transient arrives
+    void setLookahead(int numFrames) noexcept;
+    int getLookahead() const noexcept { return lookaheadFrames; }
+
+    // Processes up to maxBlockFrames interleaved frames in place and writes the
+    // gain reduction of every lane and frame, in dB, to grOut. If envelopeOut
+    // is given, the linear detector envelope is copied there as well.
+    template <typename Topology = Topologies::VCA>
+    void processBlock(SampleType* frames, float* grOut, int numFrames, float* envelopeOut = nullptr) noexcept;
+
+    // processBlock() in two halves, for callers that link detectors across
+    // stages: detect() leaves the rectified level of each lane and frame in
+    // getDetector(), which may be rewritten before compress() finishes the
+    // block. The stage's own link mode is not applied.
+    void detect(SampleType* frames, int numFrames) noexcept;
+    float* getDetector() noexcept { return scratch; }
+
+    template <typename Topology = Topologies::VCA>
+    void compress(SampleType* frames, float* grOut, int numFrames, float* envelopeOut = nullptr) noexcept;
+
+    // Only runs the lookahead delay, so a disabled stage keeps the same latency
+    void processBypassed(SampleType* frames, int numFrames) noexcept;
+    void reset();
+
+    // True when every envelope has decayed below level and no gain is being
+    // applied, so reset() would not change what the stage does next
+    bool isSettled(float level) const noexcept;
+
+private:
+    //==============================================================================
+    void rectify(const SampleType* frames, int numFrames) noexcept;
+    void lookAhead(SampleType* frames, int numFrames) noexcept;
+    void linkDetector(int numFrames) noexcept;
+
+    template <typename Topology>
+    void followEnvelope(int numFrames) noexcept;
+
+    // Detector, envelope and gain computer in one serial pass, since each
+    // frame's detector hears the gain applied to that frame
+    template <typename Topology>
+    void compressFeedback(float* grOut, int numFrames, float* envelopeOut) noexcept;
+    void computeGain(float* grOut, int numSamples) noexcept;
+    void computeGainSmoothed(float* grOut, int numFrames) noexcept;
+    void smoothGain(int numFrames) noexcept;
+    void crossfadeGain(int numFrames) noexcept;
+    void applyGain(SampleType* frames, int numSamples) const noexcept;
+
+    void updateCoefficients() noexcept;
+    void skipParameterRamps() noexcept;
+
+    // Which parts of the envelope state a topology keeps up to date
+    enum StateFlags
+    {
+        envelopeInDecibels = 1,
+        tracksMeanSquare = 2,
+        tracksProgram = 4,
+        detectsOutput = 8
+    };
+
+    template <typename Topology>
+    static constexpr int stateFlagsOf() noexcept
+    {
+        return (Topology::Smoothing::decibels ? envelopeInDecibels : 0)
+            | (Topology::Detector::usesMeanSquare ? tracksMeanSquare : 0)
+            | (Topology::Release::usesProgram ? tracksProgram : 0)
+            | (Topology::feedback ? detectsOutput : 0);
+    }
+
+    void adoptState(int newStateFlags) noexcept;
+
+    static float applyCompressionCurve(float inputDB, float threshold, float knee,
+        float inverseTwoKnee, float curveSlope) noexcept;
+
+    // The same curve without its upper clamp, and its slope in dB per dB
+    static float compressionCurveUnclamped(float inputDB, float threshold, float knee,
+        float inverseTwoKnee, float curveSlope, float& slopeOut) noexcept;
+
+    //==============================================================================
+    // Envelope state, in the domain of the last topology used
+    alignas(16) double envelope[numLanes] = {};
+    alignas(16) double meanSquare[numLanes] = {};
+    alignas(16) double programEnvelope[numLanes] = {};
+    alignas(16) float gainSmooth[numLanes] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    int stateFlags = 0;
+
+    // Gain crossfade in progress, see beginCrossfade()
+    alignas(16) float crossfadeFrom[numLanes] = {};
+    int crossfadeFrames = 0;
+    int crossfadeRemaining = 0;
+    bool crossfadeToUnity = false;
+
+    // Detector level -> envelope -> target gain -> smoothed gain, in place
+    alignas(16) float scratch[maxBlockSamples] = {};
+
+    // Per-frame curve parameters while a ramp is running
+    alignas(16) float thresholdValues[maxBlockFrames] = {};
+    alignas(16) float slopeValues[maxBlockFrames] = {};
+    alignas(16) float kneeValues[maxBlockFrames] = {};
+
+    Topologies::Ballistics ballistics;
+    float attackMs = -1.0f;       // times the coefficients were computed for
+    float releaseMs = -1.0f;
+    bool coefficientsDirty = true;
+
+    LinearRamp releaseTime;       // ms
+    LinearRamp thresholdDB;
+    LinearRamp slope;             // 1 - 1/ratio
+    LinearRamp kneeWidth;
+    double sampleRate = 44100.0;
+
+    static constexpr double parameterRampSeconds = 0.02;
+
+    // Fixed parts of the RMS and program-dependent ballistics
+    static constexpr double rmsAverageMs = 10.0;
+    static constexpr double programChargeMs = 1000.0;
+    static constexpr double programReleaseFactor = 4.0;
+
+    // Highest curve slope a feedback topology uses, so infinite ratios stay finite
+    static constexpr float maxFeedbackSlope = 59.0f;
+
+    // Newton steps per frame at most when a feedback topology solves for its
+    // gain, and how close to the answer it stops
+    static constexpr int maxFeedbackIterations = 12;
+    static constexpr float feedbackToleranceDB = 0.001f;
+
+    LinkMode linkMode = LinkMode::Unlinked;
+    int activeLanes = 2;
+
+    SidechainFilter<numLanes> sidechainFilter;
+
+    // Lookahead: delayed audio plus a running peak over the delay window
+    FrameDelay<numLanes, SampleType> audioDelay;
+    SlidingWindowMax<numLanes> peakWindow;
+    int lookaheadFrames = 0;
+
+    static constexpr double minimumCoefficient = 1.0e-9;
+
+    // Gain smoothing to prevent clicks
+    static constexpr float gainSmoothingCoef = 0.9999f;
+};
+
+//==============================================================================
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::prepare(double sr, int maxLookaheadFrames)
+{
+    sampleRate = sr;
+    coefficientsDirty = true;
+    sidechainFilter.prepare(sampleRate);
+
+    audioDelay.prepare(maxLookaheadFrames);
+    peakWindow.prepare(maxLookaheadFrames + 1);
+    setLookahead(lookaheadFrames);
+
+    releaseTime.reset(sampleRate, parameterRampSeconds);
+    thresholdDB.reset(sampleRate, parameterRampSeconds);
+    slope.reset(sampleRate, parameterRampSeconds);
+    kneeWidth.reset(sampleRate, parameterRampSeconds);
+
+    updateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::setParameters(float threshold, float r, float attack, float release, float knee)
+{
+    float ratio = std::max(1.0f, r); // Ensure ratio is at least 1:1
+
+    thresholdDB.setTargetValue(threshold);
+    slope.setTargetValue(1.0f - 1.0f / ratio);
+    kneeWidth.setTargetValue(std::max(0.0f, knee));
+
+    // Minimum times prevent instability
+    attack = std::max(0.1f, attack);
+    release = std::max(20.0f, release);
+
+    // The very first release time is taken as is rather than glided into
+    if (releaseMs < 0.0f)
+        releaseTime.setCurrentAndTargetValue(release);
+    else
+        releaseTime.setTargetValue(release);
+
+    if (attack != attackMs || releaseTime.getCurrentValue() != releaseMs)
+    {
+        attackMs = attack;
+        coefficientsDirty = true;
+    }
+
+    updateCoefficients();
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::updateCoefficients() noexcept
+{
+    if (!coefficientsDirty || attackMs < 0.0f)
+        return;
+
+    releaseMs = releaseTime.getCurrentValue();
+
+    // Convert times to coefficients: 1 - exp(-1 / samples), via expm1 so
+    // long times at high rates don't cancel to nothing. Clamp to a safe
+    // range; the floor is far below any real setting: a 10 s release at
+    // 768 kHz is 1.3e-7.
+    auto coefficient = [this](double milliseconds)
+        {
+            return std::clamp(-std::expm1(-1.0 / (milliseconds * 0.001 * sampleRate)), minimumCoefficient, 0.9999);
+        };
+
+    ballistics.attack = coefficient(attackMs);
+    ballistics.release = coefficient(releaseMs);
+    ballistics.rmsAverage = coefficient(rmsAverageMs);
+    ballistics.programCharge = coefficient(programChargeMs);
+    ballistics.programRelease = coefficient(releaseMs * programReleaseFactor);
+
+    coefficientsDirty = false;
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::setLinkMode(LinkMode mode, int numActiveLanes)
+{
+    linkMode = mode;
+    activeLanes = std::clamp(numActiveLanes, 1, numLanes);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::beginCrossfade(int numFrames, Crossfade type) noexcept
+{
+    skipParameterRamps();
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        crossfadeFrom[lane] = type == Crossfade::FadeIn ? 1.0f : gainSmooth[lane];
+
+    crossfadeToUnity = type == Crossfade::FadeOut;
+    crossfadeFrames = std::max(0, numFrames);
+    crossfadeRemaining = crossfadeFrames;
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::skipParameterRamps() noexcept
+{
+    if (releaseTime.isSmoothing())
+    {
+        releaseTime.setCurrentAndTargetValue(releaseTime.getTargetValue());
+        coefficientsDirty = true;
+        updateCoefficients();
+    }
+
+    thresholdDB.setCurrentAndTargetValue(thresholdDB.getTargetValue());
+    slope.setCurrentAndTargetValue(slope.getTargetValue());
+    kneeWidth.setCurrentAndTargetValue(kneeWidth.getTargetValue());
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::setLookahead(int numFrames) noexcept
+{
+    audioDelay.setDelay(numFrames);
+    lookaheadFrames = audioDelay.getDelay();
+
+    // The current frame plus every frame still held in the delay
+    peakWindow.setWindowLength(lookaheadFrames + 1);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::reset()
+{
+    auto floor = (stateFlags & envelopeInDecibels) != 0 ? Topologies::LogSmoothing::floor : 0.0;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        envelope[lane] = floor;
+        programEnvelope[lane] = floor;
+        meanSquare[lane] = 0.0;
+        gainSmooth[lane] = 1.0f;
+    }
+
+    // Start from the current settings rather than gliding in from old ones
+    skipParameterRamps();
+    crossfadeRemaining = 0;
+    crossfadeToUnity = false;
+
+    sidechainFilter.reset();
+    audioDelay.reset();
+    peakWindow.reset();
+}
+
+template <typename SampleType>
+inline bool BasicCompressorStage<SampleType>::isSettled(float level) const noexcept
+{
+    auto envelopeLevel = (stateFlags & envelopeInDecibels) != 0 ? FastMath::gainToDecibels(level) : level;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        if (envelope[lane] > envelopeLevel || programEnvelope[lane] > envelopeLevel
+            || meanSquare[lane] > level * level || gainSmooth[lane] < 0.9999f)
+            return false;
+
+    return sidechainFilter.isSettled(level);
+}
+
+//==============================================================================
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::adoptState(int newStateFlags) noexcept
+{
+    // Carry the envelope over to the new domain, and between the input and
+    // output level when the detection point moves (they differ by the gain
+    // being applied), so the gain doesn't jump. The mean square is always of
+    // the input. A newly used one starts at the envelope's input level, a
+    // newly used program envelope uncharged.
+    auto wasDecibels = (stateFlags & envelopeInDecibels) != 0;
+    auto toDecibels = (newStateFlags & envelopeInDecibels) != 0;
+    auto startMeanSquare = (newStateFlags & tracksMeanSquare) != 0 && (stateFlags & tracksMeanSquare) == 0;
+    auto wasOutput = (stateFlags & detectsOutput) != 0;
+    auto toOutput = (newStateFlags & detectsOutput) != 0;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        double gain = gainSmooth[lane];
+        auto levelChange = toOutput == wasOutput ? 1.0 : (toOutput ? gain : 1.0 / gain);
+        auto level = (wasDecibels ? Topologies::LogSmoothing::toLevel(envelope[lane]) : envelope[lane]) * levelChange;
+
+        auto inputLevel = toOutput ? level / gain : level;
+
+        envelope[lane] = toDecibels ? Topologies::LogSmoothing::fromLevel(level) : level;
+        meanSquare[lane] = startMeanSquare ? inputLevel * inputLevel : meanSquare[lane];
+
+        programEnvelope[lane] = toDecibels ? Topologies::LogSmoothing::floor : 0.0;
+    }
+
+    stateFlags = newStateFlags;
+}
+
+//==============================================================================
+template <typename SampleType>
+template <typename Topology>
+inline void BasicCompressorStage<SampleType>::processBlock(SampleType* frames, float* grOut, int numFrames, float* envelopeOut) noexcept
+{
+    assert(numFrames <= maxBlockFrames);
+    numFrames = std::min(numFrames, maxBlockFrames);
+
+    detect(frames, numFrames);
+
+    if (linkMode != LinkMode::Unlinked)
+        linkDetector(numFrames);
+
+    compress<Topology>(frames, grOut, numFrames, envelopeOut);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::detect(SampleType* frames, int numFrames) noexcept
+{
+    numFrames = std::min(numFrames, maxBlockFrames);
+    rectify(frames, numFrames);
+
+    if (lookaheadFrames > 0)
+        lookAhead(frames, numFrames);
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline void BasicCompressorStage<SampleType>::compress(SampleType* frames, float* grOut, int numFrames, float* envelopeOut) noexcept
+{
+    numFrames = std::min(numFrames, maxBlockFrames);
+    auto numSamples = numFrames * numLanes;
+
+    constexpr auto topologyStateFlags = stateFlagsOf<Topology>();
+    if (stateFlags != topologyStateFlags)
+        adoptState(topologyStateFlags);
+
+    if (releaseTime.isSmoothing())
+    {
+        releaseTime.skip(numFrames);
+        coefficientsDirty = true;
+        updateCoefficients();
+    }
+
+    if constexpr (Topology::feedback)
+    {
+        compressFeedback<Topology>(grOut, numFrames, envelopeOut);
+
+        if (crossfadeRemaining > 0)
+            crossfadeGain(numFrames);
+
+        applyGain(frames, numSamples);
+        return;
+    }
+
+    followEnvelope<Topology>(numFrames);
+
+    if (envelopeOut != nullptr)
+        std::copy(scratch, scratch + numSamples, envelopeOut);
+
+    if (thresholdDB.isSmoothing() || slope.isSmoothing() || kneeWidth.isSmoothing())
+        computeGainSmoothed(grOut, numFrames);
+    else
+        computeGain(grOut, numSamples);
+
+    smoothGain(numFrames);
+
+    if (crossfadeRemaining > 0)
+        crossfadeGain(numFrames);
+
+    applyGain(frames, numSamples);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::rectify(const SampleType* frames, int numFrames) noexcept
+{
+    if (sidechainFilter.isActive())
+    {
+        sidechainFilter.processRectified(frames, scratch, numFrames);
+        return;
+    }
+
+    // Use absolute value for peak detection
+    for (int i = 0; i < numFrames * numLanes; ++i)
+        scratch[i] = static_cast<float>(std::fabs(frames[i]));
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::processBypassed(SampleType* frames, int numFrames) noexcept
+{
+    if (lookaheadFrames == 0)
+        return;
+
+    numFrames = std::min(numFrames, maxBlockFrames);
+
+    // Keep the peak window filled too, so enabling the stage is seamless
+    rectify(frames, numFrames);
+    lookAhead(frames, numFrames);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::lookAhead(SampleType* frames, int numFrames) noexcept
+{
+    // The detector sees the peak of everything still in the delay line, while
+    // the audio the gain is applied to comes out lookaheadFrames later
+    peakWindow.process(scratch, numFrames);
+    audioDelay.process(frames, numFrames);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::linkDetector(int numFrames) noexcept
+{
+    // Linked modes share one detector level across the active lanes
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        auto* detector = scratch + frame * numLanes;
+        float linked = 0.0f;
+
+        if (linkMode == LinkMode::LinkedMax)
+        {
+            for (int lane = 0; lane < activeLanes; ++lane)
+                linked = std::max(linked, detector[lane]);
+        }
+        else
+        {
+            for (int lane = 0; lane < activeLanes; ++lane)
+                linked += detector[lane];
+
+            linked /= static_cast<float>(activeLanes);
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            detector[lane] = linked;
+    }
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline void BasicCompressorStage<SampleType>::followEnvelope(int numFrames) noexcept
+{
+    using Detector = typename Topology::Detector;
+    using Smoothing = typename Topology::Smoothing;
+    using Release = typename Topology::Release;
+
+    // The only truly serial step: each frame depends on the previous envelope
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        auto* detector = scratch + frame * numLanes;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            double level = Detector::level(detector[lane], meanSquare[lane], ballistics);
+            double env = Release::follow(Smoothing::fromLevel(level), envelope[lane], programEnvelope[lane],
+                ballistics.attack, ballistics);
+
+            // Clamp envelope to prevent extreme values
+            envelope[lane] = std::clamp(envelope[lane], Smoothing::floor, Smoothing::ceiling);
+            env = std::clamp(env, Smoothing::floor, Smoothing::ceiling);
+            detector[lane] = static_cast<float>(Smoothing::toLevel(env));
+        }
+    }
+}
+
+template <typename SampleType>
+template <typename Topology>
+inline void BasicCompressorStage<SampleType>::compressFeedback(float* grOut, int numFrames, float* envelopeOut) noexcept
+{
+    using Detector = typename Topology::Detector;
+    using Smoothing = typename Topology::Smoothing;
+    using Release = typename Topology::Release;
+
+    static_assert(!Smoothing::decibels, "the feedback solve assumes a linear envelope");
+
+    thresholdDB.fill(thresholdValues, numFrames);
+    slope.fill(slopeValues, numFrames);
+    kneeWidth.fill(kneeValues, numFrames);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        float threshold = thresholdValues[frame];
+        float knee = kneeValues[frame];
+        float inverseTwoKnee = knee > 0.0f ? 1.0f / (2.0f * knee) : 0.0f;
+
+        // Detecting the output turns a curve slope of k into a ratio of 1 + k,
+        // so ratio - 1 gives the ratio that was asked for
+        float inverseRatio = std::max(1.0f - slopeValues[frame], 1.0f / (maxFeedbackSlope + 1.0f));
+        float feedbackSlope = 1.0f / inverseRatio - 1.0f;
+
+        auto* values = scratch + frame * numLanes;
+
+        // The envelope after hearing this frame's output is
+        //     held + drive * gain(GR),  with  GR = curve(that envelope)
+        // Taking the gain of the frame before instead puts a frame of lag in
+        // the loop, which a fast attack drives well past the target.
+        // curve(...) - GR is convex in GR, so Newton steps from below approach
+        // the root without passing it: stopping early errs towards less gain
+        // reduction, never more. All lanes step together, so the loops stay
+        // vectorizable; most frames need no step at all.
+        alignas(16) double held[numLanes], drive[numLanes];
+        alignas(16) float heldLevel[numLanes], driveLevel[numLanes], program[numLanes];
+        alignas(16) float gainReductionDB[numLanes], gain[numLanes];
+
+        auto envelopeDB = [](float env, float programLevel)
+            {
+                return FastMath::gainToDecibels(std::max(env, programLevel) + 1e-6f);
+            };
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            // The detector runs on the input; the output it stands for is that
+            // level times the gain, which holds for the RMS window too as long
+            // as the gain moves slowly against it. That keeps the window out of
+            // the loop, where its lag would let the gain overshoot.
+            double level = Detector::level(values[lane], meanSquare[lane], ballistics);
+            double coefficient = Release::coefficient(level * gainSmooth[lane], envelope[lane], ballistics.attack, ballistics);
+
+            held[lane] = envelope[lane] * (1.0 - coefficient);
+            drive[lane] = level * coefficient;
+
+            // The solve itself only needs float
+            heldLevel[lane] = static_cast<float>(held[lane]);
+            driveLevel[lane] = static_cast<float>(drive[lane]);
+            program[lane] = static_cast<float>(programEnvelope[lane]);
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            // Neither the envelope nor its explicit step can be past the root
+            float curveSlope;
+            float lowest = std::min(static_cast<float>(envelope[lane]), heldLevel[lane] + driveLevel[lane] * gainSmooth[lane]);
+            gainReductionDB[lane] = compressionCurveUnclamped(envelopeDB(lowest, program[lane]),
+                threshold, knee, inverseTwoKnee, feedbackSlope, curveSlope);
+            gain[lane] = FastMath::decibelsToGain(-gainReductionDB[lane]);
+        }
+
+        for (int iteration = 0; iteration < maxFeedbackIterations; ++iteration)
+        {
+            alignas(16) float steps[numLanes];
+            float largestStep = 0.0f;
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                float curveSlope;
+                float env = heldLevel[lane] + driveLevel[lane] * gain[lane];
+                float error = compressionCurveUnclamped(envelopeDB(env, program[lane]),
+                    threshold, knee, inverseTwoKnee, feedbackSlope, curveSlope) - gainReductionDB[lane];
+
+                // d(envelope dB) / d(GR) is -drive * gain / envelope, or zero
+                // while the program envelope is the one heard
+                float outputShare = driveLevel[lane] * gain[lane] / (env + 1e-6f);
+                float envelopeSlope = env > program[lane] ? outputShare : 0.0f;
+                float newtonStep = error / (1.0f + curveSlope * envelopeSlope);
+                steps[lane] = error > feedbackToleranceDB ? newtonStep : 0.0f;
+                largestStep = std::max(largestStep, steps[lane]);
+            }
+
+            if (!(largestStep > 0.0f))
+                break;
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                gainReductionDB[lane] += steps[lane];
+                gain[lane] = FastMath::decibelsToGain(-gainReductionDB[lane]);
+            }
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            float gainReduction = std::min(gainReductionDB[lane], 60.0f);
+            float target = gainReductionDB[lane] > 60.0f ? FastMath::decibelsToGain(-60.0f) : gain[lane];
+
+            envelope[lane] = std::clamp(held[lane] + drive[lane] * target, Smoothing::floor, Smoothing::ceiling);
+            auto linear = static_cast<float>(Release::track(envelope[lane], programEnvelope[lane], ballistics));
+
+            float smoothed = gainSmooth[lane] + (target - gainSmooth[lane]) * gainSmoothingCoef;
+            smoothed = std::clamp(smoothed, 0.01f, 1.0f);
+
+            gainSmooth[lane] = smoothed;
+            grOut[frame * numLanes + lane] = gainReduction;
+            values[lane] = smoothed;
+
+            if (envelopeOut != nullptr)
+                envelopeOut[frame * numLanes + lane] = linear;
+        }
+    }
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::computeGain(float* grOut, int numSamples) noexcept
+{
+    // Settled parameters: one set of curve constants for the whole block
+    float threshold = thresholdDB.getTargetValue();
+    float knee = kneeWidth.getTargetValue();
+    float inverseTwoKnee = knee > 0.0f ? 1.0f / (2.0f * knee) : 0.0f;
+    float currentSlope = slope.getTargetValue();
+
+    // Convert to dB with safe floor
+    for (int i = 0; i < numSamples; ++i)
+        scratch[i] += 1e-6f;
+
+    FastMath::gainToDecibels(scratch, scratch, numSamples);
+
+    // Apply compression curve
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float gainReductionDB = applyCompressionCurve(scratch[i], threshold, knee, inverseTwoKnee, currentSlope);
+        grOut[i] = gainReductionDB;
+        scratch[i] = -gainReductionDB;
+    }
+
+    // Convert back to linear gain
+    FastMath::decibelsToGain(scratch, scratch, numSamples);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::computeGainSmoothed(float* grOut, int numFrames) noexcept
+{
+    // A parameter is gliding: take the curve constants per frame
+    thresholdDB.fill(thresholdValues, numFrames);
+    slope.fill(slopeValues, numFrames);
+    kneeWidth.fill(kneeValues, numFrames);
+
+    auto numSamples = numFrames * numLanes;
+
+    for (int i = 0; i < numSamples; ++i)
+        scratch[i] += 1e-6f;
+
+    FastMath::gainToDecibels(scratch, scratch, numSamples);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        float knee = kneeValues[frame];
+        float inverseTwoKnee = knee > 0.0f ? 1.0f / (2.0f * knee) : 0.0f;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto i = frame * numLanes + lane;
+            float gainReductionDB = applyCompressionCurve(scratch[i], thresholdValues[frame], knee,
+                inverseTwoKnee, slopeValues[frame]);
+
+            grOut[i] = gainReductionDB;
+            scratch[i] = -gainReductionDB;
+        }
+    }
+
+    FastMath::decibelsToGain(scratch, scratch, numSamples);
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::smoothGain(int numFrames) noexcept
+{
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        auto* targetGain = scratch + frame * numLanes;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            // Smooth the gain changes to prevent clicks
+            float gain = gainSmooth[lane] + (targetGain[lane] - gainSmooth[lane]) * gainSmoothingCoef;
+            gain = std::clamp(gain, 0.01f, 1.0f);
+            gainSmooth[lane] = gain;
+            targetGain[lane] = gain;
+        }
+    }
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::crossfadeGain(int numFrames) noexcept
+{
+    // Linear over the crossfade, reaching the new gain on its last frame; the
+    // gain computer's own state is left alone. A fade out holds unity to the
+    // end of the block it finishes in, as the caller stops running the stage
+    // from then on.
+    auto inverseLength = 1.0f / static_cast<float>(crossfadeFrames);
+
+    for (int frame = 0; frame < numFrames && (crossfadeRemaining > 0 || crossfadeToUnity); ++frame)
+    {
+        auto position = 1.0f;
+
+        if (crossfadeRemaining > 0)
+        {
+            --crossfadeRemaining;
+            position = static_cast<float>(crossfadeFrames - crossfadeRemaining) * inverseLength;
+        }
+
+        auto* gain = scratch + frame * numLanes;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            gain[lane] = crossfadeToUnity ? gain[lane] + (1.0f - gain[lane]) * position
+                                          : crossfadeFrom[lane] + (gain[lane] - crossfadeFrom[lane]) * position;
+    }
+
+    if (crossfadeRemaining == 0)
+        crossfadeToUnity = false;
+}
+
+template <typename SampleType>
+inline void BasicCompressorStage<SampleType>::applyGain(SampleType* frames, int numSamples) const noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        frames[i] *= scratch[i];
+}
+
+//==============================================================================
+template <typename SampleType>
+inline float BasicCompressorStage<SampleType>::applyCompressionCurve(float inputDB, float threshold, float knee,
+    float inverseTwoKnee, float curveSlope) noexcept
+{
+    float overThreshold = inputDB - threshold;
+
+    // Quadratic soft knee written without branches: the clamped term is the
+    // knee region, the remainder is the straight line above it. Below the knee
+    // both terms are zero.
+    float halfKnee = knee * 0.5f;
+    float kneeInput = std::clamp(overThreshold + halfKnee, 0.0f, knee);
+    float aboveKnee = std::max(0.0f, overThreshold - halfKnee);
+
+    float grDB = (kneeInput * kneeInput * inverseTwoKnee + aboveKnee) * curveSlope;
+    return std::clamp(grDB, 0.0f, 60.0f); // Clamp to reasonable range
+}
+
+template <typename SampleType>
+inline float BasicCompressorStage<SampleType>::compressionCurveUnclamped(float inputDB, float threshold, float knee,
+    float inverseTwoKnee, float curveSlope, float& slopeOut) noexcept
+{
+    float overThreshold = inputDB - threshold;
+    float halfKnee = knee * 0.5f;
+    float kneeInput = std::clamp(overThreshold + halfKnee, 0.0f, knee);
+    float aboveKnee = std::max(0.0f, overThreshold - halfKnee);
+
+    slopeOut = (2.0f * kneeInput * inverseTwoKnee + (aboveKnee > 0.0f ? 1.0f : 0.0f)) * curveSlope;
+    return (kneeInput * kneeInput * inverseTwoKnee + aboveKnee) * curveSlope;
+}
+
+//==============================================================================
+using CompressorStage = BasicCompressorStage<float>;
+}
@@ -0,0 +1,484 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace MixCompressorDSP
+{
+// Shared by every lane count and sample type
+enum class CrossoverPhase
+{
+    Minimum = 0,
+    Linear
+};
+
+//==============================================================================
+// Splits interleaved frames (one lane per channel) into three or four bands
+// that sum back to the input.
+//
+// Minimum phase is a Linkwitz-Riley 24 dB/oct tree: each split is LR4, and the
+// bands that skip a split go through the matching allpass, so the sum is an
+// allpass with no latency. Linear phase uses complementary FIR low-passes:
+// band i is the difference of neighbouring low-passes, and the top band is the
+// delayed input minus the highest one, so the sum is exactly the input
+// delayed by getLatency(). The low-passes and the delay are four lanes of one
+// interleaved tap set, so the filters for all bands cost one vector
+// multiply-add per tap. Their length, and so the latency, is fixed by
+// linearPhaseSeconds, which limits how low they can split: see
+// minLinearPhaseFrequency. A new crossover frequency crossfades from the old tap
+// set to the new one rather than switching, so automating it doesn't click.
+//
+// SampleType is the audio type; double runs the same filters in double.
+//==============================================================================
+template <int NumLanes, typename SampleType = float>
+class Crossover
+{
+public:
+    static constexpr int maxBands = 4;
+
+    using Phase = CrossoverPhase;
+
+    // FIR length for the linear phase split. Longer filters separate low
+    // crossovers more sharply but add latency.
+    static constexpr double linearPhaseSeconds = 0.02;
+
+    // Lowest linear phase split. The Blackman window's transition band is
+    // about 5.5 / linearPhaseSeconds (275 Hz) wide at any sample rate; a
+    // low-pass at 200 Hz is flat to 100 Hz and 39 dB down half an octave
+    // up, but one at 40 Hz is still 24 dB short of its stopband three
+    // times higher, and the low band's detector hears the low mids. Lower
+    // settings are raised to this, and the splits above kept over it.
+    static constexpr float minLinearPhaseFrequency = 200.0f;
+
+    // How long the linear phase filters take to move to new frequencies
+    static constexpr double tapCrossfadeSeconds = 0.01;
+
+    static int linearPhaseLatency(double sampleRate) noexcept
+    {
+        return (firLengthFor(sampleRate) - 1) / 2;
+    }
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        firLength = firLengthFor(sampleRate);
+        firLatency = (firLength - 1) / 2;
+        foldedLength = (firLatency + firUnroll) / firUnroll * firUnroll;
+
+        taps.assign(static_cast<size_t>(foldedLength * firLanes), SampleType());
+        previousTaps.assign(taps.size(), SampleType());
+        tapCrossfadeFrames = std::max(1, static_cast<int>(std::lround(sampleRate * tapCrossfadeSeconds)));
+        folded.assign(static_cast<size_t>(foldedLength), SampleType());
+        history.assign(static_cast<size_t>(NumLanes * firLength * 2), SampleType());
+
+        // Blackman window, shared by every low-pass
+        window.resize(static_cast<size_t>(firLength));
+        for (int n = 0; n < firLength; ++n)
+        {
+            auto angle = 2.0 * pi * n / (firLength - 1);
+            window[static_cast<size_t>(n)] = 0.42 - 0.5 * std::cos(angle) + 0.08 * std::cos(2.0 * angle);
+        }
+
+        for (auto& f : designedFrequencies)
+            f = -1.0f;
+
+        updateFilters();
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& s : split)
+            s.reset();
+
+        for (auto& a : allpass)
+            a.reset();
+
+        std::fill(history.begin(), history.end(), SampleType());
+        historyPosition = 0;
+        tapCrossfadeRemaining = 0;
+    }
+
+    // numBands of 1 turns the crossover off. A new layout starts from cleared state.
+    void setLayout(int newNumBands, Phase newPhase) noexcept
+    {
+        newNumBands = newNumBands >= 3 ? std::min(newNumBands, maxBands) : 1;
+
+        if (newNumBands == numBands && newPhase == phase)
+            return;
+
+        numBands = newNumBands;
+        phase = newPhase;
+
+        for (auto& f : designedFrequencies)
+            f = -1.0f;
+
+        updateFilters();
+        reset();
+    }
+
+    // Three bands split at f1 and f2, four at all three. Each split is held
+    // at or above the one below it, so the bands never cross over, and in
+    // linear phase at or above minLinearPhaseFrequency.
+    // Filters are only redesigned for frequencies that changed.
+    void setFrequencies(float f1, float f2, float f3) noexcept
+    {
+        frequencies[0] = f1;
+        frequencies[1] = std::max(f2, frequencies[0]);
+        frequencies[2] = std::max(f3, frequencies[1]);
+        updateFilters();
+    }
+
+    // Lanes above this carry no audio; the linear phase filters skip them
+    void setNumActiveLanes(int numActive) noexcept { activeLanes = std::clamp(numActive, 0, NumLanes); }
+
+    bool isActive() const noexcept { return numBands > 1; }
+    int getNumBands() const noexcept { return numBands; }
+    Phase getPhase() const noexcept { return phase; }
+    int getLatency() const noexcept { return isActive() && phase == Phase::Linear ? firLatency : 0; }
+
+    // bands[b] receives band b as interleaved frames, for b < getNumBands()
+    void process(const SampleType* frames, SampleType* const* bands, int numFrames) noexcept
+    {
+        if (phase == Phase::Linear)
+            processLinear(frames, bands, numFrames);
+        else if (numBands == 4)
+            processMinimum4(frames, bands, numFrames);
+        else
+            processMinimum3(frames, bands, numFrames);
+    }
+
+private:
+    //==============================================================================
+    // Trapezoidal state-variable filter, all lanes of a frame at once
+    struct Svf
+    {
+        SampleType k = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+        alignas(16) SampleType ic1[NumLanes] = {};
+        alignas(16) SampleType ic2[NumLanes] = {};
+
+        void setFrequency(double normalisedFrequency) noexcept
+        {
+            auto g = std::tan(pi * std::clamp(normalisedFrequency, 0.0, 0.45));
+            auto damping = 1.0 / butterworthQ;
+            auto d = 1.0 / (1.0 + g * (g + damping));
+
+            k = static_cast<SampleType>(damping);
+            a1 = static_cast<SampleType>(d);
+            a2 = static_cast<SampleType>(g * d);
+            a3 = static_cast<SampleType>(g * g * d);
+        }
+
+        void reset() noexcept
+        {
+            std::fill(std::begin(ic1), std::end(ic1), SampleType());
+            std::fill(std::begin(ic2), std::end(ic2), SampleType());
+        }
+
+        void tick(const SampleType* x, SampleType* low, SampleType* high) noexcept
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                SampleType v3 = x[lane] - ic2[lane];
+                SampleType v1 = a1 * ic1[lane] + a2 * v3;
+                SampleType v2 = ic2[lane] + a2 * ic1[lane] + a3 * v3;
+                ic1[lane] = 2.0f * v1 - ic1[lane];
+                ic2[lane] = 2.0f * v2 - ic2[lane];
+                low[lane] = v2;
+                high[lane] = x[lane] - k * v1 - v2;
+            }
+        }
+
+        void tickAllpass(SampleType* x) noexcept
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                SampleType v3 = x[lane] - ic2[lane];
+                SampleType v1 = a1 * ic1[lane] + a2 * v3;
+                SampleType v2 = ic2[lane] + a2 * ic1[lane] + a3 * v3;
+                ic1[lane] = 2.0f * v1 - ic1[lane];
+                ic2[lane] = 2.0f * v2 - ic2[lane];
+                x[lane] = x[lane] - 2.0f * k * v1;
+            }
+        }
+    };
+
+    // LR4 = two Butterworth sections in series on each side
+    struct Split
+    {
+        Svf a, lowB, highB;
+
+        void setFrequency(double normalisedFrequency) noexcept
+        {
+            a.setFrequency(normalisedFrequency);
+            lowB.setFrequency(normalisedFrequency);
+            highB.setFrequency(normalisedFrequency);
+        }
+
+        void reset() noexcept
+        {
+            a.reset();
+            lowB.reset();
+            highB.reset();
+        }
+
+        void tick(const SampleType* x, SampleType* low, SampleType* high) noexcept
+        {
+            alignas(16) SampleType lowA[NumLanes], highA[NumLanes], unused[NumLanes];
+            a.tick(x, lowA, highA);
+            lowB.tick(lowA, low, unused);
+            highB.tick(highA, unused, high);
+        }
+    };
+
+    //==============================================================================
+    void processMinimum4(const SampleType* frames, SampleType* const* bands, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto offset = i * NumLanes;
+            alignas(16) SampleType low[NumLanes], high[NumLanes];
+
+            split[1].tick(frames + offset, low, high);
+
+            allpass[2].tickAllpass(low);
+            split[0].tick(low, bands[0] + offset, bands[1] + offset);
+
+            allpass[0].tickAllpass(high);
+            split[2].tick(high, bands[2] + offset, bands[3] + offset);
+        }
+    }
+
+    void processMinimum3(const SampleType* frames, SampleType* const* bands, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto offset = i * NumLanes;
+            alignas(16) SampleType low[NumLanes], high[NumLanes];
+
+            split[0].tick(frames + offset, low, high);
+
+            allpass[1].tickAllpass(low);
+            std::copy(low, low + NumLanes, bands[0] + offset);
+
+            split[1].tick(high, bands[1] + offset, bands[2] + offset);
+        }
+    }
+
+    void processLinear(const SampleType* frames, SampleType* const* bands, int numFrames) noexcept
+    {
+        auto numLowPasses = numBands - 1;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto offset = i * NumLanes;
+
+            // Share of the new taps in this frame's output, while crossfading
+            auto newTapsGain = SampleType(1);
+
+            if (tapCrossfadeRemaining > 0)
+                newTapsGain = static_cast<SampleType>(1.0 - static_cast<double>(tapCrossfadeRemaining--) / tapCrossfadeFrames);
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                if (lane >= activeLanes)
+                {
+                    for (int band = 0; band < numBands; ++band)
+                        bands[band][offset + lane] = 0.0f;
+
+                    continue;
+                }
+
+                // Each lane's history is stored twice, so the last firLength
+                // samples are always one contiguous run, oldest first
+                auto* laneHistory = history.data() + lane * firLength * 2;
+                laneHistory[historyPosition] = frames[offset + lane];
+                laneHistory[historyPosition + firLength] = frames[offset + lane];
+
+                alignas(16) SampleType y[firLanes];
+                fold(laneHistory + historyPosition + 1);
+                convolve(taps.data(), y);
+
+                if (newTapsGain < SampleType(1))
+                {
+                    alignas(16) SampleType previousY[firLanes];
+                    convolve(previousTaps.data(), previousY);
+
+                    for (int band = 0; band < numLowPasses; ++band)
+                        y[band] = previousY[band] + (y[band] - previousY[band]) * newTapsGain;
+                }
+
+                // The top band's "low-pass" is the input delayed to the centre tap
+                y[numLowPasses] = laneHistory[historyPosition + 1 + firLatency];
+
+                bands[0][offset + lane] = y[0];
+
+                for (int band = 1; band < numBands; ++band)
+                    bands[band][offset + lane] = y[band] - y[band - 1];
+            }
+
+            if (++historyPosition == firLength)
+                historyPosition = 0;
+        }
+    }
+
+    // The taps are symmetric: add each sample to its mirror image first,
+    // which halves the multiplies. Padding past the centre stays zero.
+    void fold(const SampleType* samples) noexcept
+    {
+        auto* mirrored = folded.data();
+        const auto* newest = samples + firLength - 1;
+        const auto half = firLatency;
+
+        for (int n = 0; n < half; ++n)
+            mirrored[n] = samples[n] + newest[-n];
+
+        mirrored[half] = samples[half];
+    }
+
+    // One tap set against the folded history
+    void convolve(const SampleType* tapSet, SampleType* y) const noexcept
+    {
+        // Four independent accumulators keep several multiply-adds in flight;
+        // each inner loop is one vector multiply-add across the band lanes
+        alignas(16) SampleType sum0[firLanes] = {}, sum1[firLanes] = {}, sum2[firLanes] = {}, sum3[firLanes] = {};
+        const auto* t = tapSet;
+        const auto* x = folded.data();
+
+        static_assert(firUnroll == 4, "one accumulator per unrolled tap");
+
+        for (int n = 0; n < foldedLength; n += firUnroll, t += firUnroll * firLanes)
+        {
+            for (int band = 0; band < firLanes; ++band) sum0[band] += t[band] * x[n];
+            for (int band = 0; band < firLanes; ++band) sum1[band] += t[firLanes + band] * x[n + 1];
+            for (int band = 0; band < firLanes; ++band) sum2[band] += t[2 * firLanes + band] * x[n + 2];
+            for (int band = 0; band < firLanes; ++band) sum3[band] += t[3 * firLanes + band] * x[n + 3];
+        }
+
+        for (int band = 0; band < firLanes; ++band)
+            y[band] = (sum0[band] + sum1[band]) + (sum2[band] + sum3[band]);
+    }
+
+    //==============================================================================
+    void updateFilters() noexcept
+    {
+        if (!isActive())
+            return;
+
+        if (phase == Phase::Minimum)
+        {
+            for (int i = 0; i < numBands - 1; ++i)
+            {
+                if (frequencies[i] == designedFrequencies[i])
+                    continue;
+
+                designedFrequencies[i] = frequencies[i];
+                split[i].setFrequency(frequencies[i] / sampleRate);
+                allpass[i].setFrequency(frequencies[i] / sampleRate);
+            }
+
+            return;
+        }
+
+        if (taps.empty())
+            return;
+
+        // The FIR can't split lower than this; the ordering still holds
+        float linearFrequencies[maxBands - 1];
+        bool changed = false;
+
+        for (int lane = 0; lane < numBands - 1; ++lane)
+        {
+            linearFrequencies[lane] = std::max(frequencies[lane], minLinearPhaseFrequency);
+            changed = changed || linearFrequencies[lane] != designedFrequencies[lane];
+        }
+
+        if (!changed)
+            return;
+
+        // The filter being heard right now becomes the one faded out of. Mid
+        // fade, that is the blend of both tap sets, since convolution is linear.
+        if (tapCrossfadeRemaining > 0)
+        {
+            auto newTapsGain = static_cast<SampleType>(1.0 - static_cast<double>(tapCrossfadeRemaining) / tapCrossfadeFrames);
+
+            for (size_t i = 0; i < taps.size(); ++i)
+                previousTaps[i] += (taps[i] - previousTaps[i]) * newTapsGain;
+        }
+        else
+        {
+            std::copy(taps.begin(), taps.end(), previousTaps.begin());
+        }
+
+        for (int lane = 0; lane < numBands - 1; ++lane)
+        {
+            if (linearFrequencies[lane] == designedFrequencies[lane])
+                continue;
+
+            designedFrequencies[lane] = linearFrequencies[lane];
+            designLowPass(lane, linearFrequencies[lane] / sampleRate);
+        }
+
+        tapCrossfadeRemaining = tapCrossfadeFrames;
+    }
+
+    // Windowed sinc with unity gain at DC. Only the first half and the centre
+    // tap are stored; the other half mirrors them.
+    void designLowPass(int lane, double normalisedFrequency) noexcept
+    {
+        auto cutoff = std::clamp(normalisedFrequency, 0.0, 0.45);
+        double sum = 0.0;
+
+        for (int n = 0; n <= firLatency; ++n)
+        {
+            auto m = n - firLatency;
+            auto sinc = m == 0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * m) / (pi * m);
+            auto tap = sinc * window[static_cast<size_t>(n)];
+            taps[static_cast<size_t>(n * firLanes + lane)] = static_cast<SampleType>(tap);
+            sum += m == 0 ? tap : 2.0 * tap;
+        }
+
+        auto scale = sum != 0.0 ? 1.0 / sum : 0.0;
+
+        for (int n = 0; n <= firLatency; ++n)
+            taps[static_cast<size_t>(n * firLanes + lane)] *= static_cast<SampleType>(scale);
+    }
+
+    static int firLengthFor(double sampleRate) noexcept
+    {
+        return static_cast<int>(std::lround(sampleRate * linearPhaseSeconds * 0.5)) * 2 + 1;
+    }
+
+    //==============================================================================
+    static constexpr double pi = 3.14159265358979323846;
+    static constexpr double butterworthQ = 0.70710678118654752;
+    static constexpr int firLanes = maxBands; // up to three low-passes, plus the delay
+    static constexpr int firUnroll = 4;
+
+    double sampleRate = 44100.0;
+    int numBands = 1;
+    int activeLanes = NumLanes;
+    Phase phase = Phase::Minimum;
+    float frequencies[maxBands - 1] = { 120.0f, 1000.0f, 5000.0f };
+
+    // Minimum phase: splits and allpasses, indexed by crossover frequency
+    Split split[maxBands - 1];
+    Svf allpass[maxBands - 1];
+
+    // Linear phase
+    int firLength = 1;
+    int firLatency = 0;
+    int foldedLength = firUnroll;         // centre tap and one half, rounded up to firUnroll
+    std::vector<SampleType> taps;         // foldedLength frames of firLanes taps
+    std::vector<SampleType> previousTaps; // the taps being faded out of
+    std::vector<SampleType> folded;       // history folded about the centre tap
+    std::vector<SampleType> history;      // per lane, two copies of firLength samples
+    std::vector<double> window;
+    float designedFrequencies[firLanes] = { -1.0f, -1.0f, -1.0f, -1.0f }; // per split or FIR lane
+    int historyPosition = 0;
+    int tapCrossfadeFrames = 1;
+    int tapCrossfadeRemaining = 0;
+};
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MIXCOMP_HAS_CYCLE_COUNTER 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define MIXCOMP_HAS_CYCLE_COUNTER 1
+#else
+#define MIXCOMP_HAS_CYCLE_COUNTER 0
+#endif
+
+//==============================================================================
+// Timestamp helpers for the benchmark and the stage profiler. Cycles come from
+// the TSC where one is available and read as zero elsewhere; nanoseconds
+// always come from the steady clock.
+//==============================================================================
+namespace MixCompressorDSP::CycleCounter
+{
+    inline std::uint64_t readCycles() noexcept
+    {
+#if MIXCOMP_HAS_CYCLE_COUNTER
+        return static_cast<std::uint64_t>(__rdtsc());
+#else
+        return 0;
+#endif
+    }
+
+    inline std::int64_t readNanoseconds() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    constexpr bool hasCycleCounter() noexcept { return MIXCOMP_HAS_CYCLE_COUNTER != 0; }
+}
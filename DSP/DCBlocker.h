@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// One-pole DC blocker to prevent offset issues, run over interleaved frames
+// with one lane per channel.
+//==============================================================================
+template <int NumLanes, typename SampleType = float>
+class DCBlocker
+{
+public:
+    // Keeps the corner where 0.995 puts it at 44.1 kHz (about 35 Hz), rather
+    // than letting it climb with the sample rate. At 44.1 kHz the coefficient
+    // is exactly 0.995, as it always was.
+    void prepare(double sampleRate) noexcept
+    {
+        coefficient = static_cast<SampleType>(std::pow(referenceCoefficient, referenceSampleRate / sampleRate));
+    }
+
+    void reset() noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            x1[lane] = 0.0f;
+            y1[lane] = 0.0f;
+        }
+    }
+
+    // True when both filter states are below level, so silent input gives silent output
+    bool isSettled(float level) const noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+            if (x1[lane] > level || x1[lane] < -level || y1[lane] > level || y1[lane] < -level)
+                return false;
+
+        return true;
+    }
+
+    void process(SampleType* frames, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * NumLanes;
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                SampleType input = frame[lane];
+                SampleType dcBlocked = input - x1[lane] + coefficient * y1[lane];
+                x1[lane] = input;
+                y1[lane] = dcBlocked;
+                frame[lane] = dcBlocked;
+            }
+        }
+    }
+
+private:
+    alignas(16) SampleType x1[NumLanes] = {};
+    alignas(16) SampleType y1[NumLanes] = {};
+
+    static constexpr double referenceCoefficient = 0.995;
+    static constexpr double referenceSampleRate = 44100.0;
+    SampleType coefficient = static_cast<SampleType>(referenceCoefficient);
+};
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+//==============================================================================
+// Fast approximate dB/linear conversions for the gain computer.
+//
+// log2 uses the exponent bits plus an atanh series on the mantissa folded into
+// [sqrt(1/2), sqrt(2)); exp2 splits off the integer part into the exponent bits
+// and evaluates a degree-5 polynomial on the fraction in [-1/2, 1/2]. Neither
+// function branches, so the array versions auto-vectorize.
+//
+// Maximum error against std::log10 / std::pow over -120..+24 dB, checked by
+// Tools/FastMathTest (exhaustively for gainToDecibels):
+//   gainToDecibels  < 1.2e-5 dB absolute (most of it the float result's own
+//                   rounding near -120 dB)
+//   decibelsToGain  < 4e-6 relative (about 3.5e-5 dB)
+//
+// Inputs must be positive, normal floats; callers already add a small floor
+// before converting the detector level.
+//
+// tanh is a rational (Pade) approximation for the soft clipper: within 1.1e-4 of
+// std::tanh everywhere, saturating at +-5. The double versions of tanh and
+// peak serve the double precision engine.
+//
+// MIXCOMP_FAST_DB_MATH selects the path used by the compressor: 1 (default) uses
+// these kernels, 0 falls back to the exact std::log10 / std::pow versions.
+//
+// The array versions, which the gain computer runs over whole blocks, take
+// four values at a time with SSE2 where it is available (any x86-64 build).
+// They do the same operations in the same order as the scalar kernels, so
+// they give the same bits unless the compiler fuses the scalar ones into
+// FMAs. MIXCOMP_FASTMATH_SSE2=0 leaves them to the auto-vectorizer.
+//==============================================================================
+#ifndef MIXCOMP_FAST_DB_MATH
+#define MIXCOMP_FAST_DB_MATH 1
+#endif
+
+#ifndef MIXCOMP_FASTMATH_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXCOMP_FASTMATH_SSE2 1
+#else
+#define MIXCOMP_FASTMATH_SSE2 0
+#endif
+#endif
+
+#if MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace MixCompressorDSP::FastMath
+{
+    namespace detail
+    {
+        inline std::int32_t floatToBits(float x) noexcept
+        {
+            std::int32_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return bits;
+        }
+
+        inline float bitsToFloat(std::int32_t bits) noexcept
+        {
+            float x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+
+        constexpr float decibelsPerLog2 = 6.020599913f;  // 20 * log10(2)
+        constexpr float log2PerDecibel = 0.1660964047f;  // log2(10) / 20
+    }
+
+    //==============================================================================
+    inline float log2(float x) noexcept
+    {
+        auto bits = detail::floatToBits(x);
+        auto mantissaBits = bits & 0x007fffff;
+
+        // Fold the mantissa into [sqrt(1/2), sqrt(2)) to keep the series short.
+        // The fold is done on the exponent bits so the select stays branch-free.
+        auto fold = static_cast<std::int32_t>(mantissaBits > 0x003504f3);
+        auto exponent = static_cast<float>(((bits >> 23) & 0xff) - 127 + fold);
+        auto mantissa = detail::bitsToFloat(mantissaBits | (0x3f800000 - fold * (1 << 23)));
+
+        // log2(m) = 2/ln(2) * atanh((m - 1) / (m + 1))
+        float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+        float t2 = t * t;
+        float series = t * (2.885390082f + t2 * (0.9617966940f + t2 * (0.5770780164f + t2 * 0.4121985831f)));
+
+        return exponent + series;
+    }
+
+    inline float exp2(float x) noexcept
+    {
+        // Round to nearest; the exponent is clamped afterwards so out-of-range
+        // inputs saturate instead of wrapping
+        auto integer = static_cast<std::int32_t>(x + std::copysign(0.5f, x));
+        float f = x - static_cast<float>(integer); // [-1/2, 1/2]
+        integer = integer < -126 ? -126 : (integer > 126 ? 126 : integer);
+
+        // 2^f = e^(f ln2), Taylor series to degree 5
+        float p = 1.0f + f * (0.6931471806f + f * (0.2402265070f + f * (0.05550410866f
+            + f * (0.009618129108f + f * 0.001333355815f))));
+
+        auto bits = detail::floatToBits(p) + integer * (1 << 23);
+        return detail::bitsToFloat(bits);
+    }
+
+    inline float tanh(float x) noexcept
+    {
+        // Clamp |x| to 5 on the bits (integer order matches float order for the
+        // magnitude), which keeps the select branch-free
+        auto bits = detail::floatToBits(x);
+        auto magnitude = bits & 0x7fffffff;
+        magnitude = magnitude < 0x40a00000 ? magnitude : 0x40a00000;
+        x = detail::bitsToFloat((bits & ~0x7fffffff) | magnitude);
+
+        float x2 = x * x;
+        float numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        float denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return numerator / denominator;
+    }
+
+    inline double tanh(double x) noexcept
+    {
+        x = x < -5.0 ? -5.0 : (x > 5.0 ? 5.0 : x);
+
+        double x2 = x * x;
+        double numerator = x * (135135.0 + x2 * (17325.0 + x2 * (378.0 + x2)));
+        double denominator = 135135.0 + x2 * (62370.0 + x2 * (3150.0 + x2 * 28.0));
+        return numerator / denominator;
+    }
+
+    // Largest magnitude in a block, compared as integers so the loop vectorizes
+    inline float peak(const float* values, int numValues) noexcept
+    {
+        std::int32_t largest = 0;
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto magnitude = detail::floatToBits(values[i]) & 0x7fffffff;
+            largest = magnitude > largest ? magnitude : largest;
+        }
+
+        return detail::bitsToFloat(largest);
+    }
+
+    inline double peak(const double* values, int numValues) noexcept
+    {
+        std::int64_t largest = 0;
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            std::int64_t bits;
+            std::memcpy(&bits, values + i, sizeof(bits));
+            auto magnitude = bits & 0x7fffffffffffffff;
+            largest = magnitude > largest ? magnitude : largest;
+        }
+
+        double result;
+        std::memcpy(&result, &largest, sizeof(result));
+        return result;
+    }
+
+    //==============================================================================
+    inline float gainToDecibels(float gain) noexcept
+    {
+#if MIXCOMP_FAST_DB_MATH
+        return log2(gain) * detail::decibelsPerLog2;
+#else
+        return 20.0f * std::log10(gain);
+#endif
+    }
+
+    inline float decibelsToGain(float decibels) noexcept
+    {
+#if MIXCOMP_FAST_DB_MATH
+        return exp2(decibels * detail::log2PerDecibel);
+#else
+        return std::pow(10.0f, decibels * 0.05f);
+#endif
+    }
+
+#if MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2
+    //==============================================================================
+    // log2 and exp2 on four values, step for step as above
+    namespace detail
+    {
+        inline __m128 log2(__m128 x) noexcept
+        {
+            auto bits = _mm_castps_si128(x);
+            auto mantissaBits = _mm_and_si128(bits, _mm_set1_epi32(0x007fffff));
+
+            // All ones where the mantissa folds down, so subtracting it adds one
+            auto fold = _mm_cmpgt_epi32(mantissaBits, _mm_set1_epi32(0x003504f3));
+            auto biasedExponent = _mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff));
+            auto exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_sub_epi32(biasedExponent, _mm_set1_epi32(127)), fold));
+            auto mantissa = _mm_castsi128_ps(_mm_or_si128(mantissaBits,
+                _mm_sub_epi32(_mm_set1_epi32(0x3f800000), _mm_and_si128(fold, _mm_set1_epi32(1 << 23)))));
+
+            auto one = _mm_set1_ps(1.0f);
+            auto t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+            auto t2 = _mm_mul_ps(t, t);
+            auto series = _mm_add_ps(_mm_set1_ps(0.5770780164f), _mm_mul_ps(t2, _mm_set1_ps(0.4121985831f)));
+            series = _mm_add_ps(_mm_set1_ps(0.9617966940f), _mm_mul_ps(t2, series));
+            series = _mm_add_ps(_mm_set1_ps(2.885390082f), _mm_mul_ps(t2, series));
+
+            return _mm_add_ps(exponent, _mm_mul_ps(t, series));
+        }
+
+        // Clamps each value to [low, high] with compares, as SSE2 has no integer min/max
+        inline __m128i clamp(__m128i values, int low, int high) noexcept
+        {
+            auto lowValue = _mm_set1_epi32(low), highValue = _mm_set1_epi32(high);
+            auto below = _mm_cmplt_epi32(values, lowValue);
+            values = _mm_or_si128(_mm_and_si128(below, lowValue), _mm_andnot_si128(below, values));
+            auto above = _mm_cmpgt_epi32(values, highValue);
+            return _mm_or_si128(_mm_and_si128(above, highValue), _mm_andnot_si128(above, values));
+        }
+
+        inline __m128 exp2(__m128 x) noexcept
+        {
+            auto half = _mm_or_ps(_mm_and_ps(x, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f)); // copysign(0.5, x)
+            auto integer = _mm_cvttps_epi32(_mm_add_ps(x, half));
+            auto f = _mm_sub_ps(x, _mm_cvtepi32_ps(integer));
+            integer = clamp(integer, -126, 126);
+
+            auto p = _mm_add_ps(_mm_set1_ps(0.009618129108f), _mm_mul_ps(f, _mm_set1_ps(0.001333355815f)));
+            p = _mm_add_ps(_mm_set1_ps(0.05550410866f), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(0.2402265070f), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(0.6931471806f), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, p));
+
+            return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(p), _mm_slli_epi32(integer, 23)));
+        }
+    }
+#endif
+
+    //==============================================================================
+    // Array versions for lanes and scratch blocks. Either pointer may be
+    // unaligned, and they may be the same array.
+    inline void gainToDecibels(const float* gains, float* decibels, int numValues) noexcept
+    {
+        int i = 0;
+
+#if MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2
+        for (; i + 4 <= numValues; i += 4)
+            _mm_storeu_ps(decibels + i, _mm_mul_ps(detail::log2(_mm_loadu_ps(gains + i)), _mm_set1_ps(detail::decibelsPerLog2)));
+#endif
+
+        for (; i < numValues; ++i)
+            decibels[i] = gainToDecibels(gains[i]);
+    }
+
+    inline void decibelsToGain(const float* decibels, float* gains, int numValues) noexcept
+    {
+        int i = 0;
+
+#if MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2
+        for (; i + 4 <= numValues; i += 4)
+            _mm_storeu_ps(gains + i, detail::exp2(_mm_mul_ps(_mm_loadu_ps(decibels + i), _mm_set1_ps(detail::log2PerDecibel))));
+#endif
+
+        for (; i < numValues; ++i)
+            gains[i] = decibelsToGain(decibels[i]);
+    }
+}
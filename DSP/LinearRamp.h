@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cmath>
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Linear parameter ramp with the same behaviour as juce::SmoothedValue<float>
+// in linear mode: a new target is reached in a fixed number of steps.
+//==============================================================================
+class LinearRamp
+{
+public:
+    void reset(double sampleRate, double rampLengthSeconds) noexcept
+    {
+        stepsToTarget = static_cast<int>(std::floor(rampLengthSeconds * sampleRate));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        target = current = newValue;
+        countdown = 0;
+    }
+
+    void setTargetValue(float newValue) noexcept
+    {
+        if (newValue == target)
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        target = newValue;
+        countdown = stepsToTarget;
+        step = (target - current) / static_cast<float>(countdown);
+    }
+
+    float getNextValue() noexcept
+    {
+        if (countdown <= 0)
+            return target;
+
+        --countdown;
+        current = countdown > 0 ? current + step : target;
+        return current;
+    }
+
+    // Fills a block with the next values of the ramp
+    void fill(float* values, int numValues) noexcept
+    {
+        if (countdown <= 0)
+        {
+            for (int i = 0; i < numValues; ++i)
+                values[i] = target;
+
+            return;
+        }
+
+        for (int i = 0; i < numValues; ++i)
+            values[i] = getNextValue();
+    }
+
+    // Advances the ramp as if numValues had been read
+    void skip(int numValues) noexcept
+    {
+        if (numValues >= countdown)
+        {
+            setCurrentAndTargetValue(target);
+            return;
+        }
+
+        countdown -= numValues;
+        current += step * static_cast<float>(numValues);
+    }
+
+    bool isSmoothing() const noexcept { return countdown > 0; }
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+
+private:
+    float current = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int countdown = 0;
+    int stepsToTarget = 0;
+};
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Fixed-capacity delay line over interleaved frames. Works in place: each
+// frame written in comes back out numFrames later. A delay of zero passes
+// audio straight through.
+//==============================================================================
+template <int NumLanes, typename SampleType = float>
+class FrameDelay
+{
+public:
+    void prepare(int maxDelayFrames)
+    {
+        size = std::max(0, maxDelayFrames) + 1;
+        buffer.assign(static_cast<size_t>(size * NumLanes), SampleType());
+        writePosition = 0;
+        delay = std::min(delay, size - 1);
+    }
+
+    void reset() noexcept
+    {
+        std::fill(buffer.begin(), buffer.end(), SampleType());
+        writePosition = 0;
+    }
+
+    void setDelay(int numFrames) noexcept { delay = std::clamp(numFrames, 0, size - 1); }
+    int getDelay() const noexcept { return delay; }
+
+    void process(SampleType* frames, int numFrames) noexcept
+    {
+        if (delay == 0)
+            return;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * NumLanes;
+            auto* write = buffer.data() + writePosition * NumLanes;
+
+            auto readPosition = writePosition - delay;
+            if (readPosition < 0)
+                readPosition += size;
+
+            auto* read = buffer.data() + readPosition * NumLanes;
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                write[lane] = frame[lane];
+                frame[lane] = read[lane];
+            }
+
+            if (++writePosition == size)
+                writePosition = 0;
+        }
+    }
+
+private:
+    std::vector<SampleType> buffer;
+    int size = 1;
+    int writePosition = 0;
+    int delay = 0;
+};
+
+//==============================================================================
+// Running maximum over the last windowLength values of each lane, using a
+// monotonic deque: every value is pushed and popped at most once, so the cost
+// per sample is amortised O(1) whatever the window length.
+//
+// The last capacity values are kept as well, so a new window length is
+// rebuilt from them rather than starting empty: a peak already inside the
+// new window is still reported, as it is still inside the matching delay.
+//==============================================================================
+template <int NumLanes>
+class SlidingWindowMax
+{
+public:
+    void prepare(int maxWindowLength)
+    {
+        capacity = std::max(1, maxWindowLength);
+        values.assign(static_cast<size_t>(capacity * NumLanes), 0.0f);
+        times.assign(static_cast<size_t>(capacity * NumLanes), 0);
+        history.assign(static_cast<size_t>(capacity * NumLanes), 0.0f);
+        windowLength = std::min(windowLength, capacity);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        clearWindow();
+        historyPosition = 0;
+        historyLength = 0;
+        now = 0;
+    }
+
+    void setWindowLength(int length) noexcept
+    {
+        length = std::clamp(length, 1, capacity);
+
+        if (length == windowLength)
+            return;
+
+        windowLength = length;
+        clearWindow();
+
+        // Refill from the values the new window reaches back to; the next
+        // value pushed completes it
+        auto numRecent = std::min(historyLength, windowLength - 1);
+
+        for (int age = numRecent; age > 0; --age)
+        {
+            auto position = historyPosition - age;
+            if (position < 0)
+                position += capacity;
+
+            auto* frame = history.data() + position * NumLanes;
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+                push(lane, frame[lane], now - static_cast<std::uint32_t>(age));
+        }
+    }
+
+    // Replaces each lane of every frame with the maximum of that lane over the window
+    void process(float* frames, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * NumLanes;
+            auto* recent = history.data() + historyPosition * NumLanes;
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                recent[lane] = frame[lane];
+                frame[lane] = push(lane, frame[lane], now);
+            }
+
+            if (++historyPosition == capacity)
+                historyPosition = 0;
+
+            historyLength = std::min(historyLength + 1, capacity);
+            ++now;
+        }
+    }
+
+private:
+    void clearWindow() noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            head[lane] = 0;
+            count[lane] = 0;
+        }
+    }
+
+    float push(int lane, float value, std::uint32_t time) noexcept
+    {
+        auto* laneValues = values.data() + lane * capacity;
+        auto* laneTimes = times.data() + lane * capacity;
+        auto& first = head[lane];
+        auto& size = count[lane];
+
+        // Older values that are no larger can never be the maximum again
+        while (size > 0)
+        {
+            auto back = (first + size - 1) % capacity;
+
+            if (laneValues[back] > value)
+                break;
+
+            --size;
+        }
+
+        // Drop the front once it has slid out of the window
+        if (size > 0 && static_cast<int>(time - laneTimes[first]) >= windowLength)
+        {
+            first = (first + 1) % capacity;
+            --size;
+        }
+
+        auto slot = (first + size) % capacity;
+        laneValues[slot] = value;
+        laneTimes[slot] = time;
+        ++size;
+
+        return laneValues[first];
+    }
+
+    std::vector<float> values;
+    std::vector<std::uint32_t> times;
+    std::vector<float> history; // the last capacity frames, as pushed
+    int head[NumLanes] = {};
+    int count[NumLanes] = {};
+    int historyPosition = 0;
+    int historyLength = 0;
+    std::uint32_t now = 0;
+    int capacity = 1;
+    int windowLength = 1;
+};
+}
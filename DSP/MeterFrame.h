@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Meter readings for one process() call. Levels are linear, gain reduction is
+// in dB and positive. Plain data, so it can be copied through a FIFO as is.
+//==============================================================================
+struct MeterFrame
+{
+    static constexpr int maxChannels = 16;
+    static constexpr int numStages = 2;
+    static constexpr int maxBands = 4;
+
+    std::int64_t timestamp = 0; // position of the block's first sample since prepare()
+    int numChannels = 0;
+    int numSamples = 0;
+
+    float gainReduction[numStages][maxChannels] = {}; // peak per stage and channel
+    float totalGainReduction = 0.0f;                  // peak of both stages combined
+    float minGainReduction = 0.0f;                    // lowest of the same over the block
+
+    // Multiband mode only: peak gain reduction per band, all channels
+    int numBands = 0;
+    float bandGainReduction[maxBands] = {};
+
+    // Range of stage 1's detector envelope over the block, loudest channel, in dBFS
+    float detectorMinDB = -120.0f;
+    float detectorMaxDB = -120.0f;
+
+    float inputPeak[maxChannels] = {};
+    float inputRMS[maxChannels] = {};
+    float outputPeak[maxChannels] = {};
+    float outputRMS[maxChannels] = {};
+};
+}
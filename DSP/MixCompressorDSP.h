@@ -0,0 +1,23 @@
+#pragma once
+
+//==============================================================================
+// MixCompressorDSP - the compressor's signal processing, independent of JUCE.
+//
+// Header-only: add the DSP directory to the include path and include this file.
+// Everything lives in namespace MixCompressorDSP and needs only the C++17
+// standard library, so it can be embedded in offline tools and test harnesses
+// without the plugin wrapper.
+//==============================================================================
+#include "FastMath.h"
+#include "LinearRamp.h"
+#include "MeterFrame.h"
+#include "DCBlocker.h"
+#include "Lookahead.h"
+#include "SidechainFilter.h"
+#include "Crossover.h"
+#include "Topology.h"
+#include "CompressorStage.h"
+#include "OutputStage.h"
+#include "SoftClipper.h"
+#include "StageProfiler.h"
+#include "CompressorEngine.h"
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include "LinearRamp.h"
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Makeup gain and parallel (dry/wet) mix.
+// Makeup gain and mix are ramped once per frame so every channel gets the same
+// values; while neither is moving the block runs with constants.
+//==============================================================================
+class OutputStage
+{
+public:
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        makeupGain.reset(sampleRate, 0.05); // 50ms smoothing for makeup gain
+        makeupGain.setCurrentAndTargetValue(1.0f);
+
+        wetMix.reset(sampleRate, 0.02);
+
+        auto size = static_cast<size_t>(maxBlockSize > 0 ? maxBlockSize : 1);
+        gains.assign(size, 1.0f);
+        wetAmounts.assign(size, 1.0f);
+    }
+
+    // Jumps to the current makeup and mix settings instead of gliding into them
+    void reset() noexcept
+    {
+        makeupGain.setCurrentAndTargetValue(makeupGain.getTargetValue());
+        wetMix.setCurrentAndTargetValue(wetMix.getTargetValue());
+    }
+
+    void setMakeupGain(float targetGain) noexcept { makeupGain.setTargetValue(targetGain); }
+
+    void setMix(float mixPercent) noexcept { wetMix.setTargetValue(mixPercent / 100.0f); }
+
+    // True once the mix has settled at 0% or 100%, where the crossfade is trivial
+    bool isFullyDry() const noexcept { return !wetMix.isSmoothing() && wetMix.getTargetValue() <= 0.0f; }
+    bool isFullyWet() const noexcept { return !wetMix.isSmoothing() && wetMix.getTargetValue() >= 1.0f; }
+
+    // Compensate for the block's gain reduction with slight headroom
+    static float calculateAutoMakeup(float gainReductionDB) noexcept { return gainReductionDB * 0.75f; }
+
+    template <typename SampleType>
+    void process(SampleType* const* wet, const SampleType* const* dry, int numChannels, int numSamples) noexcept
+    {
+        auto numGains = static_cast<int>(gains.size());
+
+        for (int start = 0; start < numSamples; start += numGains)
+        {
+            auto num = numSamples - start < numGains ? numSamples - start : numGains;
+            makeupGain.fill(gains.data(), num);
+
+            if (wetMix.isSmoothing())
+            {
+                wetMix.fill(wetAmounts.data(), num);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto* wetData = wet[channel] + start;
+                    auto* dryData = dry[channel] + start;
+
+                    for (int i = 0; i < num; ++i)
+                    {
+                        auto w = wetAmounts[static_cast<size_t>(i)];
+                        wetData[i] = wetData[i] * gains[static_cast<size_t>(i)] * w + dryData[i] * (1.0f - w);
+                    }
+                }
+            }
+            else
+            {
+                auto w = wetMix.getTargetValue();
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto* wetData = wet[channel] + start;
+                    auto* dryData = dry[channel] + start;
+
+                    for (int i = 0; i < num; ++i)
+                        wetData[i] = wetData[i] * gains[static_cast<size_t>(i)] * w + dryData[i] * (1.0f - w);
+                }
+            }
+        }
+    }
+
+    // Makeup gain only, for a fully wet mix: no dry signal needed
+    template <typename SampleType>
+    void processWet(SampleType* const* wet, int numChannels, int numSamples) noexcept
+    {
+        if (!makeupGain.isSmoothing())
+        {
+            auto gain = makeupGain.getTargetValue();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    wet[channel][i] *= gain;
+
+            return;
+        }
+
+        auto numGains = static_cast<int>(gains.size());
+
+        for (int start = 0; start < numSamples; start += numGains)
+        {
+            auto num = numSamples - start < numGains ? numSamples - start : numGains;
+            makeupGain.fill(gains.data(), num);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* wetData = wet[channel] + start;
+
+                for (int i = 0; i < num; ++i)
+                    wetData[i] *= gains[static_cast<size_t>(i)];
+            }
+        }
+    }
+
+private:
+    LinearRamp makeupGain;
+    LinearRamp wetMix;
+    std::vector<float> gains;
+    std::vector<float> wetAmounts;
+};
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cmath>
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// High-pass filter for the detector signal only, so low end doesn't pump the
+// compressor. Trapezoidal state-variable filter, one lane per channel over
+// interleaved frames: 12 dB/oct is one Butterworth section, 24 dB/oct two.
+//==============================================================================
+template <int NumLanes>
+class SidechainFilter
+{
+public:
+    enum class Slope
+    {
+        Off = 0,
+        Slope12,
+        Slope24
+    };
+
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        frequency = -1.0f;
+        setParameters(targetFrequency, slope);
+        reset();
+    }
+
+    // Coefficients are only recomputed when the frequency actually changes
+    void setParameters(float frequencyHz, Slope newSlope) noexcept
+    {
+        targetFrequency = frequencyHz;
+
+        if (newSlope != slope)
+        {
+            slope = newSlope;
+            frequency = -1.0f;
+            reset();
+        }
+
+        if (slope == Slope::Off || frequencyHz == frequency)
+            return;
+
+        frequency = frequencyHz;
+
+        // Keep the cutoff well below Nyquist, where tan() blows up
+        auto nyquistFraction = std::fmin(static_cast<double>(frequency) / sampleRate, 0.45);
+        auto g = std::tan(3.14159265358979323846 * std::fmax(nyquistFraction, 0.0));
+
+        for (int section = 0; section < maxSections; ++section)
+        {
+            auto k = 1.0 / (slope == Slope::Slope24 ? butterworth4Q[section] : butterworth2Q);
+            auto a1 = 1.0 / (1.0 + g * (g + k));
+
+            coefficients[section].k = static_cast<float>(k);
+            coefficients[section].a1 = static_cast<float>(a1);
+            coefficients[section].a2 = static_cast<float>(g * a1);
+            coefficients[section].a3 = static_cast<float>(g * g * a1);
+        }
+    }
+
+    bool isActive() const noexcept { return slope != Slope::Off; }
+
+    void reset() noexcept
+    {
+        for (auto& section : state)
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                section.ic1[lane] = 0.0f;
+                section.ic2[lane] = 0.0f;
+            }
+    }
+
+    // True when every integrator is below level, so silent input gives silent output
+    bool isSettled(float level) const noexcept
+    {
+        for (auto& section : state)
+            for (int lane = 0; lane < NumLanes; ++lane)
+                if (std::fabs(section.ic1[lane]) > level || std::fabs(section.ic2[lane]) > level)
+                    return false;
+
+        return true;
+    }
+
+    // Writes |highpass(frames)| to detector, leaving frames untouched. Filtering
+    // and rectifying share one pass, so the detector costs no extra trip
+    // through memory.
+    template <typename SampleType>
+    void processRectified(const SampleType* frames, float* detector, int numFrames) noexcept
+    {
+        if (slope == Slope::Slope24)
+            run<2>(frames, detector, numFrames);
+        else
+            run<1>(frames, detector, numFrames);
+    }
+
+private:
+    static constexpr int maxSections = 2;
+
+    template <int NumSections, typename SampleType>
+    void run(const SampleType* frames, float* detector, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* input = frames + i * NumLanes;
+            auto* output = detector + i * NumLanes;
+
+            // Sections in series, all lanes of a frame at once
+            alignas(16) float x[NumLanes];
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+                x[lane] = static_cast<float>(input[lane]);
+
+            for (int s = 0; s < NumSections; ++s)
+            {
+                auto& c = coefficients[s];
+                auto* ic1 = state[s].ic1;
+                auto* ic2 = state[s].ic2;
+
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    float v3 = x[lane] - ic2[lane];
+                    float v1 = c.a1 * ic1[lane] + c.a2 * v3;
+                    float v2 = ic2[lane] + c.a2 * ic1[lane] + c.a3 * v3;
+                    ic1[lane] = 2.0f * v1 - ic1[lane];
+                    ic2[lane] = 2.0f * v2 - ic2[lane];
+                    x[lane] = x[lane] - c.k * v1 - v2;
+                }
+            }
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+                output[lane] = std::fabs(x[lane]);
+        }
+    }
+
+    struct Coefficients
+    {
+        float k = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    };
+
+    struct State
+    {
+        alignas(16) float ic1[NumLanes] = {};
+        alignas(16) float ic2[NumLanes] = {};
+    };
+
+    Coefficients coefficients[maxSections];
+    State state[maxSections];
+
+    double sampleRate = 44100.0;
+    float frequency = -1.0f;        // what the coefficients were computed for
+    float targetFrequency = 80.0f;
+    Slope slope = Slope::Off;
+
+    static constexpr double butterworth2Q = 0.70710678118654752;
+    static constexpr double butterworth4Q[maxSections] = { 0.54119610014619698, 1.3065629648763766 };
+};
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "FastMath.h"
+
+namespace MixCompressorDSP
+{
+//==============================================================================
+// Output soft clipper to prevent any possible overshoot.
+//
+// Samples below the knee pass straight through. Above it the curve is
+// tanh(drive * x) / drive, moved out by the 5.8e-5 it falls short of x at the
+// knee so the two pieces meet. Fast mode evaluates it with the
+// rational approximation in FastMath, which vectorizes; AntiAliased mode applies first-order
+// antiderivative anti-aliasing (ADAA) so driven peaks alias far less, at the
+// cost of half a sample of delay. The knee is decided per sample,
+// so the output doesn't depend on how the host splits its
+// blocks; blocks whose peak stays below the knee skip the nonlinearity entirely.
+//==============================================================================
+class SoftClipper
+{
+public:
+    enum class Mode
+    {
+        Off = 0,
+        Fast,
+        AntiAliased
+    };
+
+    void prepare(int numChannels)
+    {
+        states.assign(static_cast<size_t>(std::max(0, numChannels)), State{});
+    }
+
+    void reset() noexcept
+    {
+        std::fill(states.begin(), states.end(), State{});
+    }
+
+    void setMode(Mode newMode) noexcept
+    {
+        // ADAA state from before the switch would be stale
+        if (newMode != mode)
+            reset();
+
+        mode = newMode;
+    }
+
+    Mode getMode() const noexcept { return mode; }
+
+    template <typename SampleType>
+    void process(SampleType* samples, int channel, int numSamples) noexcept
+    {
+        if (mode == Mode::Off || numSamples <= 0)
+            return;
+
+        if (mode == Mode::AntiAliased && channel < static_cast<int>(states.size()))
+        {
+            processAntiAliased(samples, states[static_cast<size_t>(channel)], numSamples);
+            return;
+        }
+
+        if (FastMath::peak(samples, numSamples) >= kneeLevel)
+            processFast(samples, numSamples);
+    }
+
+    // The curve itself, exact
+    static double clip(double x) noexcept
+    {
+        return std::abs(x) < kneeLevel ? x : std::tanh(x * drive) / drive + std::copysign(kneeOffset, x);
+    }
+
+    static float clip(float x) noexcept { return static_cast<float>(clip(static_cast<double>(x))); }
+
+private:
+    struct State
+    {
+        double lastInput = 0.0;
+        double lastAntiderivative = 0.0;
+        bool antiderivativeStale = false; // lastAntiderivative wasn't needed in the straight-line region
+    };
+
+    //==============================================================================
+    template <typename SampleType>
+    static void processFast(SampleType* samples, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto x = samples[i];
+            auto y = FastMath::tanh(x * static_cast<SampleType>(drive)) * static_cast<SampleType>(inverseDrive)
+                + std::copysign(static_cast<SampleType>(kneeOffset), x);
+            samples[i] = std::abs(x) < static_cast<SampleType>(kneeLevel) ? x : y;
+        }
+    }
+
+    // Antiderivative of the curve: x^2 / 2 below the knee, and above it
+    // log(cosh(drive * x)) / drive^2 (written so it can't overflow for large
+    // inputs) plus the knee offset's share, joined at the knee
+    static double antiderivative(double x) noexcept
+    {
+        auto magnitude = std::abs(x);
+
+        if (magnitude < kneeLevel)
+            return 0.5 * x * x;
+
+        auto u = magnitude * static_cast<double>(drive);
+        return (u + std::log1p(std::exp(-2.0 * u)) - log2) / (static_cast<double>(drive) * drive)
+            + kneeOffset * magnitude + antiderivativeOffset;
+    }
+
+    template <typename SampleType>
+    void processAntiAliased(SampleType* samples, State& state, int numSamples) noexcept
+    {
+        // Straight-line region, where ADAA reduces to the average of
+        // neighbouring samples; keeps the half-sample delay consistent
+        if (FastMath::peak(samples, numSamples) < kneeLevel && std::abs(state.lastInput) < kneeLevel)
+        {
+            auto previous = static_cast<SampleType>(state.lastInput);
+            state.lastInput = samples[numSamples - 1];
+            state.antiderivativeStale = true;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto x = samples[i];
+                samples[i] = static_cast<SampleType>(0.5) * (x + previous);
+                previous = x;
+            }
+
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto input = samples[i];
+            double x = input;
+
+            // The same rule per sample, so a split block gives the same output
+            if (std::abs(x) < kneeLevel && std::abs(state.lastInput) < kneeLevel)
+            {
+                samples[i] = static_cast<SampleType>(0.5) * (input + static_cast<SampleType>(state.lastInput));
+                state.lastInput = x;
+                state.antiderivativeStale = true;
+                continue;
+            }
+
+            if (state.antiderivativeStale)
+            {
+                state.lastAntiderivative = antiderivative(state.lastInput);
+                state.antiderivativeStale = false;
+            }
+
+            auto antiderivativeX = antiderivative(x);
+            auto difference = x - state.lastInput;
+
+            // The average of the curve between the last two inputs; nearly
+            // equal inputs fall back to the curve at their midpoint
+            double y = std::abs(difference) > adaaTolerance
+                ? (antiderivativeX - state.lastAntiderivative) / difference
+                : clip(0.5 * (x + state.lastInput));
+
+            state.lastInput = x;
+            state.lastAntiderivative = antiderivativeX;
+            samples[i] = static_cast<SampleType>(y);
+        }
+    }
+
+    //==============================================================================
+    static constexpr float drive = 0.9f;
+    static constexpr float inverseDrive = 1.0f / drive;
+
+    // Below this level the curve is within 0.1% (0.009 dB) of a straight line
+    static constexpr float kneeLevel = 0.06f;
+
+    // What tanh falls short of x at the knee, and the constant that joins the
+    // two pieces of the antiderivative there
+    static inline const double kneeOffset = kneeLevel - std::tanh(static_cast<double>(drive) * kneeLevel) / drive;
+    static inline const double antiderivativeOffset = 0.5 * kneeLevel * kneeLevel
+        - std::log(std::cosh(static_cast<double>(drive) * kneeLevel)) / (static_cast<double>(drive) * drive)
+        - kneeOffset * kneeLevel;
+
+    static constexpr double adaaTolerance = 1.0e-5;
+    static constexpr double log2 = 0.69314718055994530942;
+
+    Mode mode = Mode::Fast;
+    std::vector<State> states;
+};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+// Per-stage timing of the engine, for the DSP load overlay.
+//
+// Build with MIXCOMP_ENABLE_PROFILING=1 to time the DC blocker, both stages,
+// makeup/mix and the soft clipper on every block: two timestamp reads around
+// each stage, in CPU cycles where the TSC is available and nanoseconds
+// elsewhere. With MIXCOMP_ENABLE_PROFILING=0 (the default) the profiler and
+// the MIXCOMP_PROFILE_* macros compile away entirely.
+//==============================================================================
+#ifndef MIXCOMP_ENABLE_PROFILING
+#define MIXCOMP_ENABLE_PROFILING 0
+#endif
+
+#if MIXCOMP_ENABLE_PROFILING
+#include "CycleCounter.h"
+
+namespace MixCompressorDSP
+{
+enum class ProfiledStage
+{
+    DCBlocker = 0,
+    Stage1,     // leveler, including its bands
+    Stage2,     // peak catcher, or its lookahead delay while bypassed
+    MakeupMix,  // dry copy and delay, makeup gain and the dry/wet crossfade
+    SoftClip,
+    NumStages
+};
+
+// Time spent in each stage, summed over the micro-blocks and chunks of a
+// block. Audio thread only.
+class StageProfiler
+{
+public:
+    using Ticks = std::uint64_t;
+    static constexpr int numStages = static_cast<int>(ProfiledStage::NumStages);
+
+    // Cycles where the TSC exists, nanoseconds elsewhere
+    static Ticks now() noexcept
+    {
+        return CycleCounter::hasCycleCounter() ? CycleCounter::readCycles()
+                                               : static_cast<Ticks>(CycleCounter::readNanoseconds());
+    }
+
+    void add(ProfiledStage stage, Ticks ticks) noexcept { ticksPerStage[static_cast<int>(stage)] += ticks; }
+
+    // Copies out the time per stage since the last call and starts again
+    void take(Ticks* ticks) noexcept
+    {
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            ticks[stage] = ticksPerStage[stage];
+            ticksPerStage[stage] = 0;
+        }
+    }
+
+private:
+    Ticks ticksPerStage[numStages] = {};
+};
+}
+
+#define MIXCOMP_PROFILE_BEGIN(stage) \
+    const auto profileStart##stage = MixCompressorDSP::StageProfiler::now()
+#define MIXCOMP_PROFILE_END(profiler, stage) \
+    (profiler).add(MixCompressorDSP::ProfiledStage::stage, MixCompressorDSP::StageProfiler::now() - profileStart##stage)
+#else
+#define MIXCOMP_PROFILE_BEGIN(stage) do {} while (false)
+#define MIXCOMP_PROFILE_END(profiler, stage) do {} while (false)
+#endif
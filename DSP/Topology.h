@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "FastMath.h"
+
+namespace MixCompressorDSP
+{
+// The compressor designs the stage can model; see Topologies below
+enum class Topology
+{
+    VCA = 0,  // peak detector, feed-forward: clean and precise
+    FET,      // peak detector, feedback: fast and aggressive
+    Opto,     // RMS detector, feedback, program-dependent release: slow and smooth
+    VariMu,   // RMS detector, log-domain ballistics, program-dependent release
+    NumTopologies
+};
+
+//==============================================================================
+// Compile-time strategies for the stage's detector and ballistics. A topology
+// is a bundle of four of them, and BasicCompressorStage::compress() is
+// instantiated once per topology, so none of the per-sample loops branch on
+// the mode. The engine picks the instantiation once per block.
+//
+// All levels are per lane and in double, like the stage's envelope.
+//==============================================================================
+namespace Topologies
+{
+    // Coefficients the strategies may use, all 1 - exp(-1 / samples)
+    struct Ballistics
+    {
+        double attack = 1.0;
+        double release = 1.0;
+        double rmsAverage = 1.0;     // RMS detector's averaging window
+        double programCharge = 1.0;  // how fast sustained compression slows the release
+        double programRelease = 1.0; // release of that slow component
+    };
+
+    //==============================================================================
+    // Detector: the level the envelope follows, from the rectified input
+    struct PeakDetector
+    {
+        static constexpr bool usesMeanSquare = false;
+
+        static double level(double rectified, double& /*meanSquare*/, const Ballistics&) noexcept
+        {
+            return rectified;
+        }
+    };
+
+    // Square root of a one-pole running mean square
+    struct RMSDetector
+    {
+        static constexpr bool usesMeanSquare = true;
+
+        static double level(double rectified, double& meanSquare, const Ballistics& ballistics) noexcept
+        {
+            meanSquare += (rectified * rectified - meanSquare) * ballistics.rmsAverage;
+            return std::sqrt(meanSquare);
+        }
+    };
+
+    //==============================================================================
+    // Smoothing domain: what the attack/release recursion runs on
+    struct LinearSmoothing
+    {
+        static constexpr bool decibels = false;
+        static constexpr double floor = 0.0;
+        static constexpr double ceiling = 10.0;
+
+        static double fromLevel(double level) noexcept { return level; }
+        static double toLevel(double value) noexcept { return value; }
+    };
+
+    // Decibels, so attack and release move at a constant dB rate whatever the
+    // level, as in a log-domain VCA detector
+    struct LogSmoothing
+    {
+        static constexpr bool decibels = true;
+        static constexpr double floor = -120.0;
+        static constexpr double ceiling = 20.0;
+
+        static double fromLevel(double level) noexcept
+        {
+            return FastMath::gainToDecibels(static_cast<float>(level) + 1e-6f);
+        }
+
+        static double toLevel(double value) noexcept
+        {
+            return FastMath::decibelsToGain(static_cast<float>(value));
+        }
+    };
+
+    //==============================================================================
+    // Release: how the envelope falls back once the level drops. follow() is
+    // one step of the envelope; feedback topologies, which solve for the
+    // envelope themselves, take its coefficient() and then track() the result.
+    struct FixedRelease
+    {
+        static constexpr bool usesProgram = false;
+
+        static double coefficient(double target, double envelope, double attack, const Ballistics& ballistics) noexcept
+        {
+            return target > envelope ? attack : ballistics.release;
+        }
+
+        // The level the gain follows, once the envelope has moved
+        static double track(double envelope, double& /*program*/, const Ballistics&) noexcept
+        {
+            return envelope;
+        }
+
+        static double follow(double target, double& envelope, double& program,
+            double attack, const Ballistics& ballistics) noexcept
+        {
+            envelope += (target - envelope) * coefficient(target, envelope, attack, ballistics);
+            return track(envelope, program, ballistics);
+        }
+    };
+
+    // A second, slow envelope charges while the compressor works and decays
+    // at a fraction of the release speed. Short peaks barely charge it and
+    // release quickly; sustained compression leaves a long tail, as an
+    // optical cell does.
+    struct ProgramDependentRelease
+    {
+        static constexpr bool usesProgram = true;
+
+        static double coefficient(double target, double envelope, double attack, const Ballistics& ballistics) noexcept
+        {
+            return FixedRelease::coefficient(target, envelope, attack, ballistics);
+        }
+
+        static double track(double envelope, double& program, const Ballistics& ballistics) noexcept
+        {
+            program += (envelope - program) * (envelope > program ? ballistics.programCharge : ballistics.programRelease);
+            return std::max(envelope, program);
+        }
+
+        static double follow(double target, double& envelope, double& program,
+            double attack, const Ballistics& ballistics) noexcept
+        {
+            envelope += (target - envelope) * coefficient(target, envelope, attack, ballistics);
+            return track(envelope, program, ballistics);
+        }
+    };
+
+    //==============================================================================
+    // Feed-forward topologies detect the input; feedback ones detect the
+    // output, i.e. the input times the gain being applied to it
+    template <typename DetectorType, typename SmoothingType, typename ReleaseType, bool IsFeedback>
+    struct Strategies
+    {
+        using Detector = DetectorType;
+        using Smoothing = SmoothingType;
+        using Release = ReleaseType;
+        static constexpr bool feedback = IsFeedback;
+    };
+
+    struct VCA : Strategies<PeakDetector, LinearSmoothing, FixedRelease, false> {};
+    struct FET : Strategies<PeakDetector, LinearSmoothing, FixedRelease, true> {};
+    struct Opto : Strategies<RMSDetector, LinearSmoothing, ProgramDependentRelease, true> {};
+    struct VariMu : Strategies<RMSDetector, LogSmoothing, ProgramDependentRelease, false> {};
+
+}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+//==============================================================================
+// The factory presets, as the parameter values each one sets, in the order of
+// MixCompressorAudioProcessor::PresetMode. The processor builds its preset
+// snapshots from this table, and the regression harness turns it into engine
+// parameters without a plugin instance, so it stays free of JUCE.
+//==============================================================================
+namespace FactoryPresets
+{
+    struct Value
+    {
+        const char* parameterID = nullptr;
+        float value = 0.0f; // in the parameter's own units
+    };
+
+    struct Preset
+    {
+        static constexpr int maxValues = 15;
+        Value values[maxValues] = {}; // ends at the first entry without an ID
+
+        int getNumValues() const noexcept
+        {
+            int numValues = 0;
+            while (numValues < maxValues && values[numValues].parameterID != nullptr)
+                ++numValues;
+            return numValues;
+        }
+    };
+
+    // Manual leaves every setting as it is. Only Bass Control filters the
+    // detector; the other presets switch the stage 1 sidechain HPF off.
+    inline constexpr Preset presets[] = {
+        // Manual
+        { {} },
+
+        // Vocal Leveler
+        { { { "threshold1", -18.0f }, { "ratio1", 2.5f }, { "attack1", 15.0f }, { "release1", 150.0f },
+            { "scSlope1", 0.0f }, { "dualStage", 0.0f }, { "autoMakeup", 1.0f }, { "mix", 100.0f }, { "knee", 6.0f } } },
+
+        // Drum Punch
+        { { { "threshold1", -15.0f }, { "ratio1", 4.0f }, { "attack1", 25.0f }, { "release1", 100.0f },
+            { "scSlope1", 0.0f }, { "dualStage", 0.0f }, { "autoMakeup", 1.0f }, { "mix", 100.0f }, { "knee", 3.0f } } },
+
+        // Bass Control
+        { { { "threshold1", -20.0f }, { "ratio1", 4.0f }, { "attack1", 5.0f }, { "release1", 200.0f },
+            { "scFreq1", 100.0f }, { "scSlope1", 1.0f },
+            { "dualStage", 0.0f }, { "autoMakeup", 1.0f }, { "mix", 100.0f }, { "knee", 4.0f } } },
+
+        // Mix Bus Glue
+        { { { "threshold1", -10.0f }, { "ratio1", 2.0f }, { "attack1", 30.0f }, { "release1", 300.0f },
+            { "scSlope1", 0.0f }, { "dualStage", 0.0f }, { "autoMakeup", 1.0f }, { "mix", 100.0f }, { "knee", 3.0f } } },
+
+        // Parallel Comp
+        { { { "threshold1", -25.0f }, { "ratio1", 6.0f }, { "attack1", 10.0f }, { "release1", 120.0f }, { "scSlope1", 0.0f },
+            { "dualStage", 1.0f }, { "threshold2", -10.0f }, { "ratio2", 10.0f }, { "attack2", 2.0f }, { "release2", 50.0f },
+            { "autoMakeup", 1.0f }, { "mix", 30.0f }, { "knee", 6.0f } } }
+    };
+
+    constexpr int numPresets = static_cast<int>(sizeof(presets) / sizeof(presets[0]));
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/MixCompressorDSP.h"
+
+#if MIXCOMP_ENABLE_PROFILING
+
+//==============================================================================
+// DSP load per block, as a percentage of the real-time budget (the block's
+// length in time), for each profiled stage and for the whole processBlock.
+//
+// The audio thread adds one value per series per block to a histogram of
+// atomic counters with logarithmic buckets, eight per octave from 0.001% up,
+// so p50 and p99 are good to about 9%. The reader takes the percentiles and
+// maximum of the blocks since its last call without the audio thread ever
+// waiting; counts only grow, so it works from the difference.
+//==============================================================================
+class LoadProfiler
+{
+public:
+    using Ticks = MixCompressorDSP::StageProfiler::Ticks;
+
+    static constexpr int numStages = MixCompressorDSP::StageProfiler::numStages;
+    static constexpr int totalSeries = numStages; // after the stages, in ProfiledStage order
+    static constexpr int numSeries = numStages + 1;
+
+    struct Statistics
+    {
+        float p50 = 0.0f, p99 = 0.0f, max = 0.0f; // % of the real-time budget
+    };
+
+    static const char* getSeriesName(int series) noexcept
+    {
+        static const char* const names[numSeries] = { "DC blocker", "Stage 1", "Stage 2", "Makeup/mix", "Soft clip", "Total" };
+        return series >= 0 && series < numSeries ? names[series] : "?";
+    }
+
+    // Audio thread: one block's time per stage, and for the whole block both
+    // in ticks and in nanoseconds, which calibrates the tick rate
+    void addBlock(const Ticks* stageTicks, Ticks totalTicks, std::int64_t totalNanoseconds,
+        int numSamples, double sampleRate) noexcept
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0 || totalNanoseconds <= 0)
+            return;
+
+        calibrationTicks += static_cast<double>(totalTicks);
+        calibrationNanoseconds += static_cast<double>(totalNanoseconds);
+
+        if (calibrationTicks <= 0.0)
+            return;
+
+        auto budgetNanoseconds = numSamples * 1.0e9 / sampleRate;
+        auto percentPerTick = 100.0 * calibrationNanoseconds / (calibrationTicks * budgetNanoseconds);
+
+        for (int stage = 0; stage < numStages; ++stage)
+            histograms[stage].add(static_cast<float>(static_cast<double>(stageTicks[stage]) * percentPerTick));
+
+        histograms[totalSeries].add(static_cast<float>(100.0 * static_cast<double>(totalNanoseconds) / budgetNanoseconds));
+        numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Reader only: statistics of every series over the blocks since the last
+    // call. Returns how many blocks that was; with none, leaves them alone.
+    juce::uint32 takeStatistics(Statistics* statistics) noexcept
+    {
+        auto blocks = numBlocks.load(std::memory_order_acquire);
+        auto newBlocks = blocks - lastNumBlocks;
+        lastNumBlocks = blocks;
+
+        if (newBlocks == 0)
+            return 0;
+
+        for (int series = 0; series < numSeries; ++series)
+            statistics[series] = histograms[series].take();
+
+        return newBlocks;
+    }
+
+private:
+    //==============================================================================
+    class Histogram
+    {
+    public:
+        // Single writer, so a plain load and store per counter is enough
+        void add(float percent) noexcept
+        {
+            auto& count = counts[getBucket(percent)];
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            auto currentMax = max.load(std::memory_order_relaxed);
+            while (percent > currentMax && !max.compare_exchange_weak(currentMax, percent, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        Statistics take() noexcept
+        {
+            juce::uint32 newCounts[numBuckets];
+            juce::uint32 total = 0;
+
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                auto count = counts[bucket].load(std::memory_order_relaxed);
+                newCounts[bucket] = count - lastCounts[bucket];
+                lastCounts[bucket] = count;
+                total += newCounts[bucket];
+            }
+
+            Statistics statistics;
+            statistics.max = max.exchange(0.0f, std::memory_order_relaxed);
+            statistics.p50 = juce::jmin(statistics.max, percentile(newCounts, total, 0.50));
+            statistics.p99 = juce::jmin(statistics.max, percentile(newCounts, total, 0.99));
+            return statistics;
+        }
+
+    private:
+        static constexpr int bucketsPerOctave = 8;
+        static constexpr int numBuckets = 1 + 20 * bucketsPerOctave; // up to about 1000%
+        static constexpr float lowestPercent = 0.001f;
+
+        static int getBucket(float percent) noexcept
+        {
+            if (!(percent > lowestPercent))
+                return 0;
+
+            auto bucket = 1 + static_cast<int>(std::log2(percent / lowestPercent) * bucketsPerOctave);
+            return juce::jmin(bucket, numBuckets - 1);
+        }
+
+        // Geometric centre of a bucket
+        static float getBucketValue(int bucket) noexcept
+        {
+            return bucket == 0 ? 0.0f : lowestPercent * std::exp2((static_cast<float>(bucket) - 0.5f) / bucketsPerOctave);
+        }
+
+        static float percentile(const juce::uint32* bucketCounts, juce::uint32 total, double fraction) noexcept
+        {
+            if (total == 0)
+                return 0.0f;
+
+            auto rank = static_cast<juce::uint32>(std::ceil(fraction * total));
+            juce::uint32 cumulative = 0;
+
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                cumulative += bucketCounts[bucket];
+
+                if (cumulative >= rank)
+                    return getBucketValue(bucket);
+            }
+
+            return getBucketValue(numBuckets - 1);
+        }
+
+        std::atomic<juce::uint32> counts[numBuckets] = {};
+        std::atomic<float> max{ 0.0f };
+        juce::uint32 lastCounts[numBuckets] = {}; // reader only
+    };
+
+    Histogram histograms[numSeries];
+    std::atomic<juce::uint32> numBlocks{ 0 };
+    juce::uint32 lastNumBlocks = 0; // reader only
+
+    // Audio thread only: all ticks and nanoseconds measured so far
+    double calibrationTicks = 0.0;
+    double calibrationNanoseconds = 0.0;
+};
+
+#endif
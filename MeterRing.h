@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <vector>
+#include "DSP/MeterFrame.h"
+
+//==============================================================================
+// Wait-free single-producer, single-consumer queue of meter frames from the
+// audio thread to the editor. Storage is allocated in prepare(), never while
+// audio runs. If the editor falls behind, new frames are dropped instead of
+// the audio thread waiting.
+//
+// A frame is about half a kilobyte and sessions can hold a hundred or more
+// instances, so the ring only holds what the editor might not have drained
+// yet: bufferedSeconds of the largest blocks, kept between minCapacity and
+// maxCapacity frames so hosts sending smaller blocks than announced still fit
+// a few editor ticks.
+//==============================================================================
+class MeterRing
+{
+public:
+    static constexpr double bufferedSeconds = 0.25; // several 30 Hz editor ticks
+    static constexpr int minCapacity = 64;
+    static constexpr int maxCapacity = 128;
+
+    MeterRing()
+        : fifo(minCapacity), frames(static_cast<size_t>(minCapacity))
+    {
+    }
+
+    // Not while the audio thread is pushing; safe against drain()
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        auto blocks = std::ceil(bufferedSeconds * sampleRate / juce::jmax(1, maxBlockSize));
+        auto capacity = juce::jlimit(minCapacity, maxCapacity, static_cast<int>(blocks));
+
+        const juce::SpinLock::ScopedLockType lock(readerLock);
+
+        if (capacity != fifo.getTotalSize())
+        {
+            frames.assign(static_cast<size_t>(capacity), MixCompressorDSP::MeterFrame{});
+            frames.shrink_to_fit();
+            fifo.setTotalSize(capacity);
+        }
+
+        fifo.reset();
+    }
+
+    int getCapacity() const noexcept { return fifo.getTotalSize(); }
+
+    // Audio thread only
+    bool push(const MixCompressorDSP::MeterFrame& frame) noexcept
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 == 0)
+        {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        frames[static_cast<size_t>(scope.startIndex1)] = frame;
+        return true;
+    }
+
+    // Reader only: passes every queued frame to callback, oldest first, and
+    // returns how many there were
+    template <typename Callback>
+    int drain(Callback&& callback)
+    {
+        const juce::SpinLock::ScopedLockType lock(readerLock);
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([this, &callback](int index) { callback(frames[static_cast<size_t>(index)]); });
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    juce::uint32 getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<MixCompressorDSP::MeterFrame> frames;
+    std::atomic<juce::uint32> numDropped{ 0 };
+
+    // Keeps the editor out while prepare() resizes; the audio thread never takes it
+    juce::SpinLock readerLock;
+
+    JUCE_DECLARE_NON_COPYABLE(MeterRing)
+};
@@ -27,6 +27,32 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     presetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getValueTreeState(), "preset", presetSelector);
 
+    // Stereo link selector
+    stereoLinkSelector.addItem("Unlinked", 1);
+    stereoLinkSelector.addItem("Linked (Max)", 2);
+    stereoLinkSelector.addItem("Linked (Average)", 3);
+    addAndMakeVisible(stereoLinkSelector);
+    stereoLinkAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "stereoLink", stereoLinkSelector);
+
+    // Which channels the linked modes tie together; only matters beyond stereo
+    linkGroupsSelector.addItem("Link: All Channels", 1);
+    linkGroupsSelector.addItem("Link: Fronts / Surrounds", 2);
+    linkGroupsSelector.addItem("Link: All but LFE", 3);
+    linkGroupsSelector.setEnabled(audioProcessor.getTotalNumOutputChannels() > 2);
+    addAndMakeVisible(linkGroupsSelector);
+    linkGroupsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "linkGroups", linkGroupsSelector);
+
+    // Compressor topology
+    topologySelector.addItem("VCA", 1);
+    topologySelector.addItem("FET", 2);
+    topologySelector.addItem("Opto", 3);
+    topologySelector.addItem("Vari-Mu", 4);
+    addAndMakeVisible(topologySelector);
+    topologyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "topology", topologySelector);
+
     // Stage 1 controls
     setupRotarySlider(threshold1Slider);
     setupRotarySlider(ratio1Slider);
@@ -47,6 +73,16 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     release1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getValueTreeState(), "release1", release1Slider);
 
+    setupReleaseSync(releaseSync1Selector, release1Slider);
+    releaseSync1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "releaseSync1", releaseSync1Selector);
+
+    setupSidechainControls(sidechainSlope1Selector, sidechainHPF1Slider);
+    sidechainSlope1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "scSlope1", sidechainSlope1Selector);
+    sidechainHPF1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "scFreq1", sidechainHPF1Slider);
+
     // Dual stage toggle
     dualStageToggle.setButtonText("Dual Stage");
     dualStageToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
@@ -60,11 +96,13 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     setupRotarySlider(ratio2Slider);
     setupRotarySlider(attack2Slider);
     setupRotarySlider(release2Slider);
+    setupRotarySlider(lookahead2Slider);
 
     setupLabel(threshold2Label, "THR 2");
     setupLabel(ratio2Label, "RATIO 2");
     setupLabel(attack2Label, "ATK 2");
     setupLabel(release2Label, "REL 2");
+    setupLabel(lookahead2Label, "LOOKAHEAD");
 
     threshold2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getValueTreeState(), "threshold2", threshold2Slider);
@@ -74,6 +112,18 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
         audioProcessor.getValueTreeState(), "attack2", attack2Slider);
     release2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getValueTreeState(), "release2", release2Slider);
+    lookahead2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "lookahead2", lookahead2Slider);
+
+    setupReleaseSync(releaseSync2Selector, release2Slider);
+    releaseSync2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "releaseSync2", releaseSync2Selector);
+
+    setupSidechainControls(sidechainSlope2Selector, sidechainHPF2Slider);
+    sidechainSlope2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "scSlope2", sidechainSlope2Selector);
+    sidechainHPF2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "scFreq2", sidechainHPF2Slider);
 
     // Global controls
     setupRotarySlider(makeupSlider);
@@ -98,23 +148,110 @@ MixCompressorAudioProcessorEditor::MixCompressorAudioProcessorEditor(MixCompress
     autoMakeupAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getValueTreeState(), "autoMakeup", autoMakeupToggle);
 
+    // Output soft clipper
+    clipModeSelector.addItem("Clip: Off", 1);
+    clipModeSelector.addItem("Clip: Fast", 2);
+    clipModeSelector.addItem("Clip: Anti-aliased", 3);
+    addAndMakeVisible(clipModeSelector);
+    clipModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "clipMode", clipModeSelector);
+
+    // Multiband leveler
+    bandsSelector.addItem("Bands: Off", 1);
+    bandsSelector.addItem("Bands: 3", 2);
+    bandsSelector.addItem("Bands: 4", 3);
+    addAndMakeVisible(bandsSelector);
+    bandsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "bands", bandsSelector);
+
+    crossoverPhaseSelector.addItem("Minimum Phase", 1);
+    crossoverPhaseSelector.addItem("Linear Phase", 2);
+    addAndMakeVisible(crossoverPhaseSelector);
+    crossoverPhaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), "crossoverPhase", crossoverPhaseSelector);
+
+    setupBarSlider(crossover1Slider);
+    setupBarSlider(crossover2Slider);
+    setupBarSlider(crossover3Slider);
+    crossover1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "crossover1", crossover1Slider);
+    crossover2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "crossover2", crossover2Slider);
+    crossover3Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getValueTreeState(), "crossover3", crossover3Slider);
+
     // Gain reduction meter
     addAndMakeVisible(grMeter);
+    addAndMakeVisible(grHistory);
+
+    levelReadout.setJustificationType(juce::Justification::centred);
+    levelReadout.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    levelReadout.setFont(juce::FontOptions(11.0f, juce::Font::bold));
+    addAndMakeVisible(levelReadout);
+
+    // Per-band gain reduction, drawn over the history's top edge
+    bandReadout.setJustificationType(juce::Justification::centredRight);
+    bandReadout.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    bandReadout.setFont(juce::FontOptions(10.0f, juce::Font::bold));
+    bandReadout.setInterceptsMouseClicks(false, false);
+    addAndMakeVisible(bandReadout);
+
+#if MIXCOMP_ENABLE_PROFILING
+    // DSP load overlay, off until asked for
+    loadToggle.setClickingTogglesState(true);
+    loadToggle.setColour(juce::TextButton::buttonOnColourId, accentColour);
+    loadToggle.onClick = [this]
+        {
+            // Start from a clean slate: drop whatever piled up while it was off
+            LoadProfiler::Statistics discarded[LoadProfiler::numSeries];
+            audioProcessor.getLoadProfiler().takeStatistics(discarded);
+
+            loadOverlay.setVisible(loadToggle.getToggleState());
+            loadRefreshCountdown = loadRefreshTicks;
+        };
+    addAndMakeVisible(loadToggle);
+
+    loadOverlay.setInterceptsMouseClicks(false, false);
+    addChildComponent(loadOverlay);
+#endif
+
+    // Discard frames left over from an earlier editor, then ask for new ones
+    audioProcessor.getMeterRing().drain([](const MixCompressorDSP::MeterFrame&) {});
+    audioProcessor.setMeteringActive(true);
 
     // Start timer for metering updates
-    startTimerHz(30);
+    startTimerHz(visibleRefreshHz);
 
-    setSize(800, 500);
+    setOpaque(true);
+    setSize(800, 620);
 }
 
 MixCompressorAudioProcessorEditor::~MixCompressorAudioProcessorEditor()
 {
     stopTimer();
+    audioProcessor.setMeteringActive(false);
 }
 
 //==============================================================================
 void MixCompressorAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (background.isNull() || scale != backgroundScale)
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void MixCompressorAudioProcessorEditor::renderBackground(float scale)
+{
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+        juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+    backgroundScale = scale;
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     g.fillAll(backgroundColour);
 
     // Title
@@ -131,7 +268,7 @@ void MixCompressorAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(panelColour);
     g.fillRoundedRectangle(15, 70, 770, 180, 5);  // Stage 1
     g.fillRoundedRectangle(15, 260, 770, 180, 5); // Stage 2
-    g.fillRoundedRectangle(600, 450, 185, 35, 5); // Controls
+    g.fillRoundedRectangle(600, 570, 185, 35, 5); // Controls
 
     // Section labels
     g.setColour(accentColour);
@@ -143,13 +280,18 @@ void MixCompressorAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colours::lightgrey);
     g.setFont(juce::FontOptions(10.0f));
     g.drawText("Use Stage 1 for smooth leveling | Stage 2 for peak control",
-        25, 240, 400, 15, juce::Justification::left);
+        25, 240, 360, 15, juce::Justification::left);
 }
 
 void MixCompressorAudioProcessorEditor::resized()
 {
+    background = {};
+
     // Preset selector
     presetSelector.setBounds(600, 15, 185, 30);
+    stereoLinkSelector.setBounds(400, 15, 185, 28);
+    linkGroupsSelector.setBounds(400, 46, 185, 20);
+    topologySelector.setBounds(600, 48, 185, 20);
 
     // Stage 1 controls
     int stage1Y = 100;
@@ -164,6 +306,10 @@ void MixCompressorAudioProcessorEditor::resized()
 
     release1Slider.setBounds(390, stage1Y, 100, 100);
     release1Label.setBounds(390, stage1Y + 105, 100, 20);
+    releaseSync1Selector.setBounds(390, stage1Y + 128, 100, 18);
+
+    sidechainSlope1Selector.setBounds(250, 75, 120, 20);
+    sidechainHPF1Slider.setBounds(380, 75, 110, 20);
 
     // Stage 2 toggle
     dualStageToggle.setBounds(25, 290, 150, 25);
@@ -181,6 +327,13 @@ void MixCompressorAudioProcessorEditor::resized()
 
     release2Slider.setBounds(330, stage2Y, 80, 80);
     release2Label.setBounds(330, stage2Y + 85, 80, 20);
+    releaseSync2Selector.setBounds(330, stage2Y + 107, 80, 18);
+
+    lookahead2Slider.setBounds(430, stage2Y, 80, 80);
+    lookahead2Label.setBounds(430, stage2Y + 85, 80, 20);
+
+    sidechainSlope2Selector.setBounds(250, 265, 120, 20);
+    sidechainHPF2Slider.setBounds(380, 265, 110, 20);
 
     // Global controls
     makeupSlider.setBounds(520, stage1Y, 100, 100);
@@ -193,17 +346,115 @@ void MixCompressorAudioProcessorEditor::resized()
     kneeLabel.setBounds(520, stage2Y + 85, 100, 20);
 
     autoMakeupToggle.setBounds(640, stage2Y + 30, 140, 25);
+    clipModeSelector.setBounds(640, stage2Y + 65, 140, 25);
+
+    // Multiband: mode in stage 1's title row, crossovers under its knobs
+    bandsSelector.setBounds(510, 75, 130, 20);
+    crossoverPhaseSelector.setBounds(650, 75, 130, 20);
+    crossover1Slider.setBounds(500, 230, 90, 16);
+    crossover2Slider.setBounds(595, 230, 90, 16);
+    crossover3Slider.setBounds(690, 230, 90, 16);
+
+    // Gain reduction history and meter
+    grHistory.setBounds(15, 450, 770, 110);
+    grMeter.setBounds(15, 570, 570, 35);
+    levelReadout.setBounds(605, 575, 175, 25);
+    bandReadout.setBounds(420, 452, 360, 16);
+
+#if MIXCOMP_ENABLE_PROFILING
+    loadToggle.setBounds(330, 15, 60, 20);
+    loadOverlay.setBounds(60, 466, 300, 90);
+#endif
+}
 
-    // Gain reduction meter
-    grMeter.setBounds(15, 450, 570, 35);
+void MixCompressorAudioProcessorEditor::updateRefreshRate()
+{
+    auto showing = isShowing();
+
+    if (showing == meterVisible)
+        return;
+
+    meterVisible = showing;
+
+    // Nothing is drawn while hidden, so the audio thread stops producing frames too
+    if (showing)
+        audioProcessor.getMeterRing().drain([](const MixCompressorDSP::MeterFrame&) {});
+
+    audioProcessor.setMeteringActive(showing);
+    startTimerHz(showing ? visibleRefreshHz : hiddenRefreshHz);
 }
 
 void MixCompressorAudioProcessorEditor::timerCallback()
 {
-    // Update gain reduction meter
-    float gr = audioProcessor.getCurrentGainReduction();
+    // A hidden editor (closed plugin window, minimised host) only polls until it's shown again
+    updateRefreshRate();
+
+    if (!meterVisible)
+        return;
+
+#if MIXCOMP_ENABLE_PROFILING
+    updateLoadOverlay();
+#endif
+
+    // Take every block since the last tick so short peaks aren't missed
+    float gr = 0.0f;
+    float inputPeak = 0.0f;
+    float outputPeak = 0.0f;
+    int numBands = 0;
+    float bandGR[MixCompressorDSP::MeterFrame::maxBands] = {};
+
+    grHistory.setSampleRate(audioProcessor.getSampleRate());
+
+    auto numFrames = audioProcessor.getMeterRing().drain([&](const MixCompressorDSP::MeterFrame& frame)
+        {
+            gr = juce::jmax(gr, frame.totalGainReduction);
+            grHistory.addFrame(frame);
+
+            for (int channel = 0; channel < frame.numChannels; ++channel)
+            {
+                inputPeak = juce::jmax(inputPeak, frame.inputPeak[channel]);
+                outputPeak = juce::jmax(outputPeak, frame.outputPeak[channel]);
+            }
+
+            numBands = frame.numBands;
+            for (int band = 0; band < frame.numBands; ++band)
+                bandGR[band] = juce::jmax(bandGR[band], frame.bandGainReduction[band]);
+        });
+
+    // Nothing new (transport stopped, or no audio callbacks): hold the display
+    if (numFrames == 0)
+        return;
+
     grMeter.setGainReduction(gr);
+    grHistory.repaint();
+
+    levelReadout.setText("IN " + juce::String(juce::Decibels::gainToDecibels(inputPeak), 1)
+        + "  OUT " + juce::String(juce::Decibels::gainToDecibels(outputPeak), 1) + " dB",
+        juce::dontSendNotification);
+
+    juce::String bands;
+    for (int band = 0; band < numBands; ++band)
+        bands << "  B" << (band + 1) << " -" << juce::String(bandGR[band], 1);
+
+    bandReadout.setText(bands.isEmpty() ? bands : "BAND GR" + bands + " dB", juce::dontSendNotification);
+}
+
+#if MIXCOMP_ENABLE_PROFILING
+void MixCompressorAudioProcessorEditor::updateLoadOverlay()
+{
+    if (!loadOverlay.isVisible() || --loadRefreshCountdown > 0)
+        return;
+
+    loadRefreshCountdown = loadRefreshTicks;
+
+    // Statistics cover the blocks since the last update; with none (transport
+    // stopped) the overlay holds its numbers
+    LoadProfiler::Statistics statistics[LoadProfiler::numSeries];
+
+    if (audioProcessor.getLoadProfiler().takeStatistics(statistics) > 0)
+        loadOverlay.setStatistics(statistics);
 }
+#endif
 
 //==============================================================================
 void MixCompressorAudioProcessorEditor::setupRotarySlider(juce::Slider& slider)
@@ -227,9 +478,91 @@ void MixCompressorAudioProcessorEditor::setupLabel(juce::Label& label, const juc
     addAndMakeVisible(label);
 }
 
+void MixCompressorAudioProcessorEditor::setupSidechainControls(juce::ComboBox& slopeSelector, juce::Slider& frequencySlider)
+{
+    slopeSelector.addItem("SC HPF: Off", 1);
+    slopeSelector.addItem("SC HPF: 12 dB", 2);
+    slopeSelector.addItem("SC HPF: 24 dB", 3);
+    addAndMakeVisible(slopeSelector);
+
+    setupBarSlider(frequencySlider);
+}
+
+void MixCompressorAudioProcessorEditor::setupReleaseSync(juce::ComboBox& syncSelector, juce::Slider& releaseSlider)
+{
+    for (auto* item : { "Free", "1/2", "1/4", "1/8", "1/16", "1/32" })
+        syncSelector.addItem(item, syncSelector.getNumItems() + 1);
+
+    // The knob has no effect while the release follows the host tempo
+    syncSelector.onChange = [&syncSelector, &releaseSlider]
+    {
+        releaseSlider.setEnabled(syncSelector.getSelectedItemIndex() <= 0);
+    };
+
+    addAndMakeVisible(syncSelector);
+}
+
+void MixCompressorAudioProcessorEditor::setupBarSlider(juce::Slider& slider)
+{
+    slider.setSliderStyle(juce::Slider::LinearBar);
+    slider.setColour(juce::Slider::trackColourId, accentColour.withAlpha(0.5f));
+    slider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
+    slider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
+    addAndMakeVisible(slider);
+}
+
 //==============================================================================
-void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics& g)
+juce::Rectangle<float> MixCompressorAudioProcessorEditor::GainReductionMeter::getMeterBounds() const
 {
+    auto bounds = getLocalBounds().toFloat().reduced(2);
+    bounds.removeFromLeft(120); // label
+    return bounds.reduced(5, 5);
+}
+
+juce::Rectangle<float> MixCompressorAudioProcessorEditor::GainReductionMeter::getBarBounds(float gr) const
+{
+    if (gr <= displayThreshold)
+        return {};
+
+    auto meterBounds = getMeterBounds();
+    return meterBounds.withWidth(juce::jmap(juce::jmin(gr, 18.0f), 0.0f, 18.0f, 0.0f, meterBounds.getWidth()));
+}
+
+juce::Rectangle<float> MixCompressorAudioProcessorEditor::GainReductionMeter::getValueBounds() const
+{
+    auto meterBounds = getMeterBounds();
+    return meterBounds.withWidth(100).translated(meterBounds.getWidth() - 100, -15);
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionMeter::setGainReduction(float gr)
+{
+    if (std::abs(gr - gainReduction) < repaintThreshold)
+        return;
+
+    auto oldBar = getBarBounds(gainReduction);
+    auto newBar = getBarBounds(gr);
+    auto wasShown = gainReduction > displayThreshold;
+    gainReduction = gr;
+
+    // The union of both bars also covers the colour changing at 6 and 12 dB
+    auto dirty = oldBar.getUnion(newBar);
+
+    if (wasShown || gr > displayThreshold)
+        dirty = dirty.getUnion(getValueBounds());
+
+    if (!dirty.isEmpty())
+        repaint(dirty.getSmallestIntegerContainer().expanded(1));
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionMeter::renderBackground(float scale)
+{
+    background = juce::Image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+        juce::jmax(1, juce::roundToInt(getHeight() * scale)), true);
+    backgroundScale = scale;
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     auto bounds = getLocalBounds().toFloat().reduced(2);
 
     // Background
@@ -241,10 +574,8 @@ void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics
     g.setFont(juce::FontOptions(11.0f, juce::Font::bold));
     g.drawText("GAIN REDUCTION", bounds.removeFromLeft(120), juce::Justification::centredLeft);
 
-    // Meter area
-    auto meterBounds = bounds.reduced(5, 5);
-
     // Scale markings
+    auto meterBounds = getMeterBounds();
     g.setColour(juce::Colours::grey);
     g.setFont(juce::FontOptions(9.0f));
     for (int db = 0; db >= -18; db -= 3)
@@ -255,14 +586,21 @@ void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics
         g.drawText(juce::String(db), static_cast<int>(x - 10), static_cast<int>(meterBounds.getBottom() - 12),
             20, 12, juce::Justification::centred);
     }
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (background.isNull() || scale != backgroundScale)
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
 
     // Gain reduction bar
-    if (gainReduction > 0.1f)
+    if (gainReduction > displayThreshold)
     {
         float grClamped = juce::jmin(gainReduction, 18.0f);
-        float barWidth = juce::jmap(grClamped, 0.0f, 18.0f, 0.0f, meterBounds.getWidth());
-
-        auto grRect = meterBounds.withWidth(barWidth);
 
         // Color gradient based on amount of GR
         juce::Colour meterColour;
@@ -274,13 +612,239 @@ void MixCompressorAudioProcessorEditor::GainReductionMeter::paint(juce::Graphics
             meterColour = juce::Colour(0xffff4444); // Red - heavy
 
         g.setColour(meterColour);
-        g.fillRoundedRectangle(grRect, 2);
+        g.fillRoundedRectangle(getBarBounds(gainReduction), 2);
 
         // Value text
         g.setColour(juce::Colours::white);
         g.setFont(juce::FontOptions(13.0f, juce::Font::bold));
-        g.drawText(juce::String(gainReduction, 1) + " dB",
-            meterBounds.withWidth(100).translated(meterBounds.getWidth() - 100, -15),
-            juce::Justification::centredRight);
+        g.drawText(juce::String(gainReduction, 1) + " dB", getValueBounds(), juce::Justification::centredRight);
+    }
+}
+
+//==============================================================================
+MixCompressorAudioProcessorEditor::GainReductionHistory::GainReductionHistory()
+    : columns(static_cast<size_t>(maxColumns))
+{
+    setOpaque(true);
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::Column::add(const MixCompressorDSP::MeterFrame& frame)
+{
+    if (!hasData)
+    {
+        detectorMin = frame.detectorMinDB;
+        detectorMax = frame.detectorMaxDB;
+        gainReductionMin = frame.minGainReduction;
+        gainReductionMax = frame.totalGainReduction;
+        hasData = true;
+        return;
+    }
+
+    detectorMin = juce::jmin(detectorMin, frame.detectorMinDB);
+    detectorMax = juce::jmax(detectorMax, frame.detectorMaxDB);
+    gainReductionMin = juce::jmin(gainReductionMin, frame.minGainReduction);
+    gainReductionMax = juce::jmax(gainReductionMax, frame.totalGainReduction);
+}
+
+juce::Rectangle<int> MixCompressorAudioProcessorEditor::GainReductionHistory::getPlotBounds() const
+{
+    auto bounds = getLocalBounds().reduced(8, 8);
+    bounds.removeFromLeft(30); // scale
+    bounds.removeFromTop(14);  // title and legend
+    return bounds;
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::resized()
+{
+    background = {};
+    updateColumnLength();
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    updateColumnLength();
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::updateColumnLength()
+{
+    numColumns = juce::jlimit(1, maxColumns, getPlotBounds().getWidth());
+    samplesPerColumn = sampleRate * historySeconds / numColumns;
+    clear();
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::clear()
+{
+    std::fill(columns.begin(), columns.end(), Column());
+    current = {};
+    writeIndex = 0;
+    started = false;
+    repaint();
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::pushColumn()
+{
+    columns[static_cast<size_t>(writeIndex)] = current;
+    writeIndex = (writeIndex + 1) % numColumns;
+    current = {};
+    columnEnd += samplesPerColumn;
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::addFrame(const MixCompressorDSP::MeterFrame& frame)
+{
+    if (samplesPerColumn <= 0.0 || frame.numSamples <= 0)
+        return;
+
+    auto start = static_cast<double>(frame.timestamp);
+    auto end = start + frame.numSamples;
+
+    // Timestamps restart when the host prepares again, and after a gap longer
+    // than the whole view there is nothing left worth scrolling
+    if (!started || start < columnEnd - samplesPerColumn || start >= columnEnd + numColumns * samplesPerColumn)
+    {
+        clear();
+        columnEnd = start + samplesPerColumn;
+        started = true;
+    }
+
+    // Columns no block fell into stay empty
+    while (start >= columnEnd)
+        pushColumn();
+
+    // A block longer than a column shows up in every column it covers
+    current.add(frame);
+
+    while (end > columnEnd)
+    {
+        pushColumn();
+        current.add(frame);
+    }
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::renderBackground(float scale)
+{
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+        juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+    backgroundScale = scale;
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    g.fillAll(juce::Colour(0xff1a1a1a));
+    g.setColour(juce::Colour(0xff0a0a0a));
+    g.fillRoundedRectangle(getLocalBounds().toFloat().reduced(2), 3);
+
+    auto plot = getPlotBounds().toFloat();
+
+    // Title and legend
+    g.setFont(juce::FontOptions(11.0f, juce::Font::bold));
+    g.setColour(juce::Colours::white);
+    g.drawText("GR HISTORY", 10, 4, 150, 14, juce::Justification::centredLeft);
+    g.setColour(juce::Colour(0xff4a9eff));
+    g.drawText("DETECTOR", getWidth() - 240, 4, 100, 14, juce::Justification::centredRight);
+    g.setColour(juce::Colour(0xffff4444));
+    g.drawText("GAIN REDUCTION", getWidth() - 130, 4, 120, 14, juce::Justification::centredRight);
+
+    // Detector level falls from the top, gain reduction hangs from it: one dB
+    // scale serves both
+    g.setFont(juce::FontOptions(9.0f));
+    for (int db = 0; db <= static_cast<int>(rangeDB); db += 12)
+    {
+        float y = juce::jmap(static_cast<float>(db), 0.0f, rangeDB, plot.getY(), plot.getBottom());
+        g.setColour(juce::Colour(0xff2d2d2d));
+        g.drawHorizontalLine(juce::roundToInt(y), plot.getX(), plot.getRight());
+        g.setColour(juce::Colours::grey);
+        g.drawText(juce::String(-db), static_cast<int>(plot.getX() - 30), static_cast<int>(y - 6),
+            26, 12, juce::Justification::centredRight);
     }
-}
\ No newline at end of file
+}
+
+void MixCompressorAudioProcessorEditor::GainReductionHistory::paint(juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (background.isNull() || scale != backgroundScale)
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+
+    auto plot = getPlotBounds().toFloat();
+    auto toY = [&plot](float db)
+    {
+        return juce::jmap(juce::jlimit(0.0f, rangeDB, db), 0.0f, rangeDB, plot.getY(), plot.getBottom());
+    };
+
+    // One column per pixel, oldest on the left; the column still filling is the newest
+    auto drawColumn = [&](const Column& column, float x)
+    {
+        if (!column.hasData)
+            return;
+
+        auto gainReductionTop = toY(column.gainReductionMin);
+        auto gainReductionBottom = toY(column.gainReductionMax);
+        g.setColour(juce::Colour(0x40ff4444));
+        g.fillRect(x, plot.getY(), 1.0f, gainReductionTop - plot.getY());
+        g.setColour(juce::Colour(0xffff4444));
+        g.fillRect(x, gainReductionTop, 1.0f, juce::jmax(1.0f, gainReductionBottom - gainReductionTop));
+
+        if (column.detectorMax < -rangeDB)
+            return;
+
+        auto detectorTop = toY(-column.detectorMax);
+        auto detectorBottom = toY(-column.detectorMin);
+        g.setColour(juce::Colour(0xff4a9eff));
+        g.fillRect(x, detectorTop, 1.0f, juce::jmax(1.0f, detectorBottom - detectorTop));
+    };
+
+    for (int i = 1; i < numColumns; ++i)
+        drawColumn(columns[static_cast<size_t>((writeIndex + i) % numColumns)], plot.getX() + static_cast<float>(i - 1));
+
+    drawColumn(current, plot.getX() + static_cast<float>(numColumns - 1));
+}
+
+#if MIXCOMP_ENABLE_PROFILING
+//==============================================================================
+void MixCompressorAudioProcessorEditor::LoadOverlay::setStatistics(const LoadProfiler::Statistics* newStatistics)
+{
+    std::copy(newStatistics, newStatistics + LoadProfiler::numSeries, statistics);
+    repaint();
+}
+
+void MixCompressorAudioProcessorEditor::LoadOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.8f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    auto area = getLocalBounds().reduced(8, 4);
+    auto rowHeight = area.getHeight() / (LoadProfiler::numSeries + 1);
+    auto columnWidth = (area.getWidth() - 100) / 3;
+
+    auto drawRow = [&](const juce::String& name, const juce::String& p50, const juce::String& p99, const juce::String& max)
+        {
+            auto row = area.removeFromTop(rowHeight);
+            g.drawText(name, row.removeFromLeft(100), juce::Justification::centredLeft);
+            g.drawText(p50, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+            g.drawText(p99, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+            g.drawText(max, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+        };
+
+    g.setFont(juce::FontOptions(10.0f, juce::Font::bold));
+    g.setColour(juce::Colours::grey);
+    drawRow("% OF BUDGET", "p50", "p99", "max");
+
+    auto percent = [](float value) { return juce::String(value, value < 10.0f ? 2 : 1); };
+
+    for (int series = 0; series < LoadProfiler::numSeries; ++series)
+    {
+        auto& s = statistics[series];
+        auto isTotal = series == LoadProfiler::totalSeries;
+
+        g.setColour(isTotal ? juce::Colours::white : juce::Colours::lightgrey);
+        g.setFont(juce::FontOptions(10.0f, isTotal ? juce::Font::bold : juce::Font::plain));
+        drawRow(LoadProfiler::getSeriesName(series), percent(s.p50), percent(s.p99), percent(s.max));
+    }
+}
+#endif
@@ -18,16 +18,95 @@ public:
 
 private:
     //==============================================================================
+    // Background, label and scale are drawn once into an image; a new value
+    // only repaints the part of the bar and the readout that changed
     class GainReductionMeter : public juce::Component
     {
     public:
         void paint(juce::Graphics& g) override;
-        void setGainReduction(float gr) { gainReduction = gr; repaint(); }
+        void resized() override { background = {}; }
+        void setGainReduction(float gr);
 
     private:
+        static constexpr float displayThreshold = 0.1f;   // dB below which no bar is drawn
+        static constexpr float repaintThreshold = 0.05f;  // half the readout's resolution
+
+        juce::Rectangle<float> getMeterBounds() const;
+        juce::Rectangle<float> getBarBounds(float gr) const;
+        juce::Rectangle<float> getValueBounds() const;
+        void renderBackground(float scale);
+
         float gainReduction = 0.0f;
+        juce::Image background;
+        float backgroundScale = 0.0f;
+    };
+
+    //==============================================================================
+    // Scrolling view of stage 1's detector envelope and the applied gain
+    // reduction over the last few seconds. Meter frames are binned into one
+    // column per pixel, each keeping only the min and max of the blocks that
+    // fell into it, so memory and drawing cost follow the width, not the
+    // sample rate. The column ring is allocated once.
+    class GainReductionHistory : public juce::Component
+    {
+    public:
+        GainReductionHistory();
+
+        void paint(juce::Graphics& g) override;
+        void resized() override;
+
+        void setSampleRate(double newSampleRate);
+        void addFrame(const MixCompressorDSP::MeterFrame& frame);
+        void clear();
+
+    private:
+        struct Column
+        {
+            float detectorMin = 0.0f, detectorMax = 0.0f;
+            float gainReductionMin = 0.0f, gainReductionMax = 0.0f;
+            bool hasData = false;
+
+            void add(const MixCompressorDSP::MeterFrame& frame);
+        };
+
+        static constexpr int maxColumns = 2048;
+        static constexpr double historySeconds = 5.0;
+        static constexpr float rangeDB = 48.0f;
+
+        juce::Rectangle<int> getPlotBounds() const;
+        void updateColumnLength();
+        void pushColumn();
+        void renderBackground(float scale);
+
+        std::vector<Column> columns; // ring of finished columns, oldest at writeIndex
+        int numColumns = 1;
+        int writeIndex = 0;
+        Column current;
+
+        double sampleRate = 0.0;
+        double samplesPerColumn = 0.0;
+        double columnEnd = 0.0;   // sample position where the current column ends
+        bool started = false;
+
+        juce::Image background;
+        float backgroundScale = 0.0f;
     };
 
+#if MIXCOMP_ENABLE_PROFILING
+    //==============================================================================
+    // Table of each stage's DSP load over the last half second, in percent of
+    // the real-time budget, drawn over the history while it's switched on
+    class LoadOverlay : public juce::Component
+    {
+    public:
+        void paint(juce::Graphics& g) override;
+        void setStatistics(const LoadProfiler::Statistics* newStatistics);
+
+    private:
+        LoadProfiler::Statistics statistics[LoadProfiler::numSeries];
+    };
+#endif
+
     //==============================================================================
     MixCompressorAudioProcessor& audioProcessor;
 
@@ -35,6 +114,15 @@ private:
     juce::ComboBox presetSelector;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> presetAttachment;
 
+    juce::ComboBox stereoLinkSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoLinkAttachment;
+
+    juce::ComboBox linkGroupsSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> linkGroupsAttachment;
+
+    juce::ComboBox topologySelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> topologyAttachment;
+
     // Stage 1 controls
     juce::Slider threshold1Slider, ratio1Slider, attack1Slider, release1Slider;
     juce::Label threshold1Label, ratio1Label, attack1Label, release1Label;
@@ -42,16 +130,31 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ratio1Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attack1Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> release1Attachment;
+    juce::ComboBox releaseSync1Selector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> releaseSync1Attachment;
+
+    juce::ComboBox sidechainSlope1Selector;
+    juce::Slider sidechainHPF1Slider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sidechainSlope1Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sidechainHPF1Attachment;
 
     // Stage 2 controls
     juce::ToggleButton dualStageToggle;
-    juce::Slider threshold2Slider, ratio2Slider, attack2Slider, release2Slider;
-    juce::Label threshold2Label, ratio2Label, attack2Label, release2Label;
+    juce::Slider threshold2Slider, ratio2Slider, attack2Slider, release2Slider, lookahead2Slider;
+    juce::Label threshold2Label, ratio2Label, attack2Label, release2Label, lookahead2Label;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> dualStageAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> threshold2Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ratio2Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attack2Attachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> release2Attachment;
+    juce::ComboBox releaseSync2Selector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> releaseSync2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lookahead2Attachment;
+
+    juce::ComboBox sidechainSlope2Selector;
+    juce::Slider sidechainHPF2Slider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sidechainSlope2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sidechainHPF2Attachment;
 
     // Global controls
     juce::Slider makeupSlider, mixSlider, kneeSlider;
@@ -62,16 +165,53 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> kneeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoMakeupAttachment;
 
+    juce::ComboBox clipModeSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> clipModeAttachment;
+
+    // Multiband controls
+    juce::ComboBox bandsSelector, crossoverPhaseSelector;
+    juce::Slider crossover1Slider, crossover2Slider, crossover3Slider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandsAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> crossoverPhaseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossover1Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossover2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossover3Attachment;
+
     // Metering
     GainReductionMeter grMeter;
+    GainReductionHistory grHistory;
+    juce::Label levelReadout;
+    juce::Label bandReadout;
+
+#if MIXCOMP_ENABLE_PROFILING
+    juce::TextButton loadToggle{ "LOAD" };
+    LoadOverlay loadOverlay;
+    int loadRefreshCountdown = 0;
+    static constexpr int loadRefreshTicks = 15; // about twice a second
+    void updateLoadOverlay();
+#endif
 
     // Styling
     juce::Colour backgroundColour;
     juce::Colour panelColour;
     juce::Colour accentColour;
 
+    // Panels, titles and section labels, drawn once per size and display scale
+    juce::Image background;
+    float backgroundScale = 0.0f;
+
+    // Refresh rates while the editor is on screen and while it is hidden
+    static constexpr int visibleRefreshHz = 30;
+    static constexpr int hiddenRefreshHz = 4;
+    bool meterVisible = true;
+
     void setupRotarySlider(juce::Slider& slider);
     void setupLabel(juce::Label& label, const juce::String& text);
+    void setupBarSlider(juce::Slider& slider);
+    void setupSidechainControls(juce::ComboBox& slopeSelector, juce::Slider& frequencySlider);
+    void setupReleaseSync(juce::ComboBox& syncSelector, juce::Slider& releaseSlider);
+    void renderBackground(float scale);
+    void updateRefreshRate();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixCompressorAudioProcessorEditor)
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
+#include "FactoryPresets.h"
 
 //==============================================================================
 MixCompressorAudioProcessor::MixCompressorAudioProcessor()
@@ -15,11 +17,49 @@ MixCompressorAudioProcessor::MixCompressorAudioProcessor()
 #endif
     apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    makeupGainSmoothed.reset(44100.0, 0.05); // 50ms smoothing for makeup gain
+    threshold1Param = apvts.getRawParameterValue("threshold1");
+    ratio1Param = apvts.getRawParameterValue("ratio1");
+    attack1Param = apvts.getRawParameterValue("attack1");
+    release1Param = apvts.getRawParameterValue("release1");
+    releaseSync1Param = apvts.getRawParameterValue("releaseSync1");
+    sidechainHPF1Param = apvts.getRawParameterValue("scFreq1");
+    sidechainSlope1Param = apvts.getRawParameterValue("scSlope1");
+    kneeParam = apvts.getRawParameterValue("knee");
+    dualStageParam = apvts.getRawParameterValue("dualStage");
+    threshold2Param = apvts.getRawParameterValue("threshold2");
+    ratio2Param = apvts.getRawParameterValue("ratio2");
+    attack2Param = apvts.getRawParameterValue("attack2");
+    release2Param = apvts.getRawParameterValue("release2");
+    releaseSync2Param = apvts.getRawParameterValue("releaseSync2");
+    sidechainHPF2Param = apvts.getRawParameterValue("scFreq2");
+    sidechainSlope2Param = apvts.getRawParameterValue("scSlope2");
+    lookahead2Param = apvts.getRawParameterValue("lookahead2");
+    makeupParam = apvts.getRawParameterValue("makeup");
+    autoMakeupParam = apvts.getRawParameterValue("autoMakeup");
+    mixParam = apvts.getRawParameterValue("mix");
+    stereoLinkParam = apvts.getRawParameterValue("stereoLink");
+    linkGroupsParam = apvts.getRawParameterValue("linkGroups");
+    clipModeParam = apvts.getRawParameterValue("clipMode");
+    topologyParam = apvts.getRawParameterValue("topology");
+    bandsParam = apvts.getRawParameterValue("bands");
+    crossoverPhaseParam = apvts.getRawParameterValue("crossoverPhase");
+    crossover1Param = apvts.getRawParameterValue("crossover1");
+    crossover2Param = apvts.getRawParameterValue("crossover2");
+    crossover3Param = apvts.getRawParameterValue("crossover3");
+
+    buildPresetSnapshots();
+
+    apvts.addParameterListener("lookahead2", this);
+    apvts.addParameterListener("bands", this);
+    apvts.addParameterListener("crossoverPhase", this);
 }
 
 MixCompressorAudioProcessor::~MixCompressorAudioProcessor()
 {
+    apvts.removeParameterListener("lookahead2", this);
+    apvts.removeParameterListener("bands", this);
+    apvts.removeParameterListener("crossoverPhase", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -27,6 +67,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
+    // Note lengths a release can be synced to, matching getReleaseMs()
+    const juce::StringArray releaseSyncChoices{ "Free", "1/2", "1/4", "1/8", "1/16", "1/32" };
+
     // Preset selector
     layout.add(std::make_unique<juce::AudioParameterChoice>(
         "preset", "Preset",
@@ -58,6 +101,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
         juce::String(), juce::AudioProcessorParameter::genericParameter,
         [](float value, int) { return juce::String(value, 0) + " ms"; }));
 
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "releaseSync1", "Release 1 Sync", releaseSyncChoices, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "scFreq1", "Sidechain HPF 1",
+        juce::NormalisableRange<float>(20.0f, 500.0f, 1.0f, 0.4f), 80.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value, 0) + " Hz"; }));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "scSlope1", "Sidechain Slope 1",
+        juce::StringArray{ "Off", "12 dB/oct", "24 dB/oct" },
+        0));
+
     // Stage 2 (Peak Catcher) parameters
     layout.add(std::make_unique<juce::AudioParameterBool>(
         "dualStage", "Dual Stage", false));
@@ -86,6 +143,26 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
         juce::String(), juce::AudioProcessorParameter::genericParameter,
         [](float value, int) { return juce::String(value, 0) + " ms"; }));
 
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "releaseSync2", "Release 2 Sync", releaseSyncChoices, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "scFreq2", "Sidechain HPF 2",
+        juce::NormalisableRange<float>(20.0f, 500.0f, 1.0f, 0.4f), 80.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value, 0) + " Hz"; }));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "scSlope2", "Sidechain Slope 2",
+        juce::StringArray{ "Off", "12 dB/oct", "24 dB/oct" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "lookahead2", "Lookahead 2",
+        juce::NormalisableRange<float>(0.0f, MixCompressorDSP::CompressorEngine::maxLookaheadMs, 0.1f), 0.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value, 1) + " ms"; }));
+
     // Global parameters
     layout.add(std::make_unique<juce::AudioParameterFloat>(
         "makeup", "Makeup Gain",
@@ -108,33 +185,89 @@ juce::AudioProcessorValueTreeState::ParameterLayout MixCompressorAudioProcessor:
         juce::String(), juce::AudioProcessorParameter::genericParameter,
         [](float value, int) { return juce::String(value, 1) + " dB"; }));
 
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "stereoLink", "Stereo Link",
+        juce::StringArray{ "Unlinked", "Linked (Max)", "Linked (Average)" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "linkGroups", "Link Groups",
+        juce::StringArray{ "All Channels", "Fronts / Surrounds", "All but LFE" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "clipMode", "Soft Clip",
+        juce::StringArray{ "Off", "Fast", "Anti-aliased" },
+        1));
+
+    // Detector and ballistics of stage 1, in the order of MixCompressorDSP::Topology
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "topology", "Topology",
+        juce::StringArray{ "VCA", "FET", "Opto", "Vari-Mu" },
+        0));
+
+    // Multiband leveler
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "bands", "Bands",
+        juce::StringArray{ "Off", "3 Bands", "4 Bands" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "crossoverPhase", "Crossover Phase",
+        juce::StringArray{ "Minimum Phase", "Linear Phase" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "crossover1", "Crossover Low",
+        juce::NormalisableRange<float>(40.0f, 500.0f, 1.0f, 0.5f), 120.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value, 0) + " Hz"; }));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "crossover2", "Crossover Mid",
+        juce::NormalisableRange<float>(200.0f, 4000.0f, 1.0f, 0.4f), 1000.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value, 0) + " Hz"; }));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "crossover3", "Crossover High",
+        juce::NormalisableRange<float>(1000.0f, 12000.0f, 1.0f, 0.4f), 5000.0f,
+        juce::String(), juce::AudioProcessorParameter::genericParameter,
+        [](float value, int) { return juce::String(value / 1000.0f, 1) + " kHz"; }));
+
     return layout;
 }
 
 //==============================================================================
 void MixCompressorAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    stage1.prepare(sampleRate);
-    stage2.prepare(sampleRate);
-
-    makeupGainSmoothed.reset(sampleRate, 0.05);
-    makeupGainSmoothed.setCurrentAndTargetValue(1.0f);
+    // The engine allocates all of its scratch storage here, never on the audio thread
+    auto numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
 
-    inputRMS = 0.0f;
-    outputRMS = 0.0f;
+    updateLinkGroupTable();
+    meterRing.prepare(sampleRate, samplesPerBlock);
+    appliedLinkGroupMode = -1;
+    appliedPresetGeneration = presetState.load() >> presetIndexBits;
+    updateLatency();
 
-    // Reset DC blocker
-    for (int i = 0; i < 2; ++i)
+    if (isUsingDoublePrecision())
     {
-        dcBlockerX1[i] = 0.0f;
-        dcBlockerY1[i] = 0.0f;
+        doubleEngine.prepare(sampleRate, samplesPerBlock, numChannels);
+        applyLatencySettings(doubleEngine);
+    }
+    else
+    {
+        engine.prepare(sampleRate, samplesPerBlock, numChannels);
+        applyLatencySettings(engine);
     }
 }
 
 void MixCompressorAudioProcessor::releaseResources()
 {
-    stage1.reset();
-    stage2.reset();
+    if (isUsingDoublePrecision())
+        doubleEngine.reset();
+    else
+        engine.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -144,8 +277,9 @@ bool MixCompressorAudioProcessor::isBusesLayoutSupported(const BusesLayout& layo
     juce::ignoreUnused(layouts);
     return true;
 #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout the engine has lanes for: mono, stereo, surround, ambisonic or discrete
+    auto numChannels = layouts.getMainOutputChannelSet().size();
+    if (numChannels < 1 || numChannels > maxChannels)
         return false;
 
 #if ! JucePlugin_IsSynth
@@ -161,327 +295,306 @@ bool MixCompressorAudioProcessor::isBusesLayoutSupported(const BusesLayout& layo
 void MixCompressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer, engine);
+}
+
+void MixCompressorAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, doubleEngine);
+}
+
+template <typename SampleType>
+void MixCompressorAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer,
+                                                 MixCompressorDSP::BasicCompressorEngine<SampleType>& target)
+{
+    RealtimeSafety::ScopedAudioCallback realtimeScope;
     juce::ScopedNoDenormals noDenormals;
 
+#if MIXCOMP_ENABLE_PROFILING
+    auto blockStartTicks = MixCompressorDSP::StageProfiler::now();
+    auto blockStartNanoseconds = MixCompressorDSP::CycleCounter::readNanoseconds();
+#endif
+
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto bpm = position->getBpm())
+                hostBpm = juce::jlimit(20.0, 999.0, *bpm);
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get parameters safely
-    auto* threshold1Param = apvts.getRawParameterValue("threshold1");
-    auto* ratio1Param = apvts.getRawParameterValue("ratio1");
-    auto* attack1Param = apvts.getRawParameterValue("attack1");
-    auto* release1Param = apvts.getRawParameterValue("release1");
-    auto* kneeParam = apvts.getRawParameterValue("knee");
-    auto* dualStageParam = apvts.getRawParameterValue("dualStage");
-    auto* threshold2Param = apvts.getRawParameterValue("threshold2");
-    auto* ratio2Param = apvts.getRawParameterValue("ratio2");
-    auto* attack2Param = apvts.getRawParameterValue("attack2");
-    auto* release2Param = apvts.getRawParameterValue("release2");
-    auto* makeupParam = apvts.getRawParameterValue("makeup");
-    auto* autoMakeupParam = apvts.getRawParameterValue("autoMakeup");
-    auto* mixParam = apvts.getRawParameterValue("mix");
-
-    if (!threshold1Param || !ratio1Param || !attack1Param || !release1Param || !kneeParam ||
-        !dualStageParam || !threshold2Param || !ratio2Param || !attack2Param || !release2Param ||
-        !makeupParam || !autoMakeupParam || !mixParam)
+    // Parameters are cached in the constructor
+    if (!threshold1Param || !ratio1Param || !attack1Param || !release1Param || !releaseSync1Param || !kneeParam ||
+        !sidechainHPF1Param || !sidechainSlope1Param ||
+        !dualStageParam || !threshold2Param || !ratio2Param || !attack2Param || !release2Param || !releaseSync2Param ||
+        !sidechainHPF2Param || !sidechainSlope2Param ||
+        !makeupParam || !autoMakeupParam || !mixParam || !stereoLinkParam || !linkGroupsParam || !clipModeParam || !topologyParam ||
+        !crossover1Param || !crossover2Param || !crossover3Param)
         return;
 
-    auto threshold1 = threshold1Param->load();
-    auto ratio1 = ratio1Param->load();
-    auto attack1 = attack1Param->load();
-    auto release1 = release1Param->load();
-    auto knee = kneeParam->load();
+    // A preset being loaded overrides the values it sets, so no block sees
+    // half of it. If one is published while the values are read, read again.
+    MixCompressorDSP::Parameters parameters;
+    auto preset = presetState.load();
 
-    auto dualStage = dualStageParam->load() > 0.5f;
-    auto threshold2 = threshold2Param->load();
-    auto ratio2 = ratio2Param->load();
-    auto attack2 = attack2Param->load();
-    auto release2 = release2Param->load();
+    for (int attempt = 0;; ++attempt)
+    {
+        auto presetIndex = static_cast<int>(preset & ((1u << presetIndexBits) - 1)) - 1;
+        readParameters(parameters, presetIndex >= 0 ? &presetSnapshots[presetIndex] : nullptr);
 
-    auto makeupDB = makeupParam->load();
-    auto autoMakeup = autoMakeupParam->load() > 0.5f;
-    auto mixPercent = mixParam->load();
+        auto current = presetState.load();
+        if (current == preset || attempt == 2)
+            break;
 
-    // Set compressor parameters
-    stage1.setParameters(threshold1, ratio1, attack1, release1, knee);
-    stage2.setParameters(threshold2, ratio2, attack2, release2, knee);
+        preset = current;
+    }
 
-    // Create dry buffer for parallel processing
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
+    longestReleaseMs.store(juce::jmax(parameters.release1, parameters.dualStage ? parameters.release2 : 0.0f));
 
-    float maxGR = 0.0f;
-    float sumInputSq = 0.0f;
-    float sumOutputSq = 0.0f;
+    // A new lookahead or crossover only takes effect once its latency has been reported
+    applyLatencySettings(target);
 
-    // Process audio sample-by-sample for smooth gain changes
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    auto linkGroupMode = juce::jlimit(0, static_cast<int>(LinkGroupMode::NumModes) - 1, static_cast<int>(linkGroupsParam->load()));
+    if (linkGroupMode != appliedLinkGroupMode)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            float input = channelData[i];
+        target.setLinkGroups(linkGroupTable[linkGroupMode], maxChannels);
+        appliedLinkGroupMode = linkGroupMode;
+    }
 
-            // DC blocker to prevent offset issues
-            float dcBlocked = input - dcBlockerX1[channel] + dcBlockerCoef * dcBlockerY1[channel];
-            dcBlockerX1[channel] = input;
-            dcBlockerY1[channel] = dcBlocked;
-            input = dcBlocked;
+    // Detailed metering only while someone is watching
+    auto metering = meteringActive.load(std::memory_order_relaxed);
+    target.setMeteringEnabled(metering);
 
-            sumInputSq += input * input;
+    // A new preset lands in one go, crossfaded
+    auto presetGeneration = preset >> presetIndexBits;
 
-            // Stage 1: Leveler
-            float gr1 = 0.0f;
-            float output = stage1.processSample(input, gr1);
+    if (presetGeneration != appliedPresetGeneration)
+    {
+        target.crossfadeToParameters(parameters);
+        appliedPresetGeneration = presetGeneration;
+    }
+    else
+    {
+        target.setParameters(parameters);
+    }
 
-            // Stage 2: Peak Catcher (if enabled)
-            float gr2 = 0.0f;
-            if (dualStage)
-                output = stage2.processSample(output, gr2);
+    target.process(buffer.getArrayOfWritePointers(), totalNumInputChannels, buffer.getNumSamples());
 
-            float totalGR = gr1 + gr2;
-            maxGR = juce::jmax(maxGR, totalGR);
+    if (metering)
+        meterRing.push(target.getMeterFrame());
 
-            channelData[i] = output;
-            sumOutputSq += output * output;
-        }
-    }
+#if MIXCOMP_ENABLE_PROFILING
+    MixCompressorDSP::StageProfiler::Ticks stageTicks[MixCompressorDSP::StageProfiler::numStages];
+    target.getProfiler().take(stageTicks);
+    loadProfiler.addBlock(stageTicks, MixCompressorDSP::StageProfiler::now() - blockStartTicks,
+        MixCompressorDSP::CycleCounter::readNanoseconds() - blockStartNanoseconds, buffer.getNumSamples(), getSampleRate());
+#endif
+}
 
-    // Update RMS values
-    int numSamples = buffer.getNumSamples() * totalNumInputChannels;
-    if (numSamples > 0)
-    {
-        float instantInputRMS = std::sqrt(sumInputSq / numSamples);
-        float instantOutputRMS = std::sqrt(sumOutputSq / numSamples);
+//==============================================================================
+void MixCompressorAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
 
-        inputRMS = rmsAlpha * inputRMS + (1.0f - rmsAlpha) * instantInputRMS;
-        outputRMS = rmsAlpha * outputRMS + (1.0f - rmsAlpha) * instantOutputRMS;
-    }
+    // May be called on the audio thread during automation
+    triggerAsyncUpdate();
+}
 
-    // Calculate and smooth makeup gain
-    float targetMakeupGain = juce::Decibels::decibelsToGain(makeupDB);
+void MixCompressorAudioProcessor::handleAsyncUpdate()
+{
+    updateLatency();
+}
 
-    if (autoMakeup && maxGR > 0.01f)
-    {
-        float autoMakeupDB = calculateAutoMakeup(maxGR);
-        targetMakeupGain = juce::Decibels::decibelsToGain(autoMakeupDB);
-    }
+void MixCompressorAudioProcessor::updateLatency()
+{
+    if (!lookahead2Param || !bandsParam || !crossoverPhaseParam)
+        return;
 
-    makeupGainSmoothed.setTargetValue(targetMakeupGain);
+    using Engine = MixCompressorDSP::CompressorEngine;
 
-    // Apply mix (parallel compression) with smoothed makeup gain
-    float wetMix = mixPercent / 100.0f;
-    float dryMix = 1.0f - wetMix;
+    // Choice index 0 is off, which the engine counts as a single band
+    static constexpr int bandsForChoice[] = { 1, 3, 4 };
+    auto bands = bandsForChoice[juce::jlimit(0, 2, static_cast<int>(bandsParam->load()))];
+    auto linearPhase = crossoverPhaseParam->load() > 0.5f;
+    auto phase = linearPhase ? Engine::CrossoverPhase::Linear : Engine::CrossoverPhase::Minimum;
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* wetData = buffer.getWritePointer(channel);
-        auto* dryData = dryBuffer.getReadPointer(channel);
+    auto lookahead = Engine::lookaheadMsToSamples(lookahead2Param->load(), getSampleRate());
+    lookaheadSamples.store(lookahead);
+    numBands.store(bands);
+    linearPhaseCrossover.store(linearPhase);
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            float makeupGain = makeupGainSmoothed.getNextValue();
-            float wet = wetData[i] * makeupGain;
-            float dry = dryData[i];
-            wetData[i] = wet * wetMix + dry * dryMix;
-
-            // Soft clip to prevent any possible overshoot
-            wetData[i] = std::tanh(wetData[i] * 0.9f) / 0.9f;
-        }
-    }
+    auto samples = lookahead + Engine::crossoverLatencySamples(bands, phase, getSampleRate());
 
-    // Update gain reduction meter
-    currentGainReduction.store(maxGR);
+    if (samples != getLatencySamples())
+        setLatencySamples(samples);
 }
 
-//==============================================================================
-float MixCompressorAudioProcessor::calculateAutoMakeup(float avgGainReduction)
+template <typename SampleType>
+void MixCompressorAudioProcessor::applyLatencySettings(MixCompressorDSP::BasicCompressorEngine<SampleType>& target) noexcept
 {
-    // Compensate for average gain reduction with slight headroom
-    return avgGainReduction * 0.75f;
+    auto lookahead = lookaheadSamples.load();
+    if (lookahead != target.getLookahead())
+        target.setLookahead(lookahead);
+
+    auto phase = linearPhaseCrossover.load() ? MixCompressorDSP::CrossoverPhase::Linear
+                                             : MixCompressorDSP::CrossoverPhase::Minimum;
+    target.setCrossover(numBands.load(), phase);
 }
 
-//==============================================================================
-void MixCompressorAudioProcessor::loadPreset(PresetMode preset)
+void MixCompressorAudioProcessor::readParameters(MixCompressorDSP::Parameters& parameters, const PresetSnapshot* preset) const noexcept
 {
-    auto* presetParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("preset"));
-    if (presetParam)
-        *presetParam = static_cast<int>(preset);
-
-    auto* threshold1Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("threshold1"));
-    auto* ratio1Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("ratio1"));
-    auto* attack1Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("attack1"));
-    auto* release1Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("release1"));
-    auto* dualStageParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("dualStage"));
-    auto* threshold2Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("threshold2"));
-    auto* ratio2Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("ratio2"));
-    auto* attack2Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("attack2"));
-    auto* release2Param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("release2"));
-    auto* autoMakeupParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("autoMakeup"));
-    auto* mixParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("mix"));
-    auto* kneeParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("knee"));
-
-    if (!threshold1Param || !ratio1Param || !attack1Param || !release1Param || !dualStageParam ||
-        !threshold2Param || !ratio2Param || !attack2Param || !release2Param || !autoMakeupParam ||
-        !mixParam || !kneeParam)
-        return;
-
-    switch (preset)
+    auto value = [preset](const std::atomic<float>* rawValue)
     {
-    case PresetMode::VocalLeveler:
-        *threshold1Param = -18.0f;
-        *ratio1Param = 2.5f;
-        *attack1Param = 15.0f;
-        *release1Param = 150.0f;
-        *dualStageParam = false;
-        *autoMakeupParam = true;
-        *mixParam = 100.0f;
-        *kneeParam = 6.0f;
-        break;
-
-    case PresetMode::DrumPunch:
-        *threshold1Param = -15.0f;
-        *ratio1Param = 4.0f;
-        *attack1Param = 25.0f;
-        *release1Param = 100.0f;
-        *dualStageParam = false;
-        *autoMakeupParam = true;
-        *mixParam = 100.0f;
-        *kneeParam = 3.0f;
-        break;
-
-    case PresetMode::BassControl:
-        *threshold1Param = -20.0f;
-        *ratio1Param = 4.0f;
-        *attack1Param = 5.0f;
-        *release1Param = 200.0f;
-        *dualStageParam = false;
-        *autoMakeupParam = true;
-        *mixParam = 100.0f;
-        *kneeParam = 4.0f;
-        break;
-
-    case PresetMode::MixBusGlue:
-        *threshold1Param = -10.0f;
-        *ratio1Param = 2.0f;
-        *attack1Param = 30.0f;
-        *release1Param = 300.0f;
-        *dualStageParam = false;
-        *autoMakeupParam = true;
-        *mixParam = 100.0f;
-        *kneeParam = 3.0f;
-        break;
-
-    case PresetMode::ParallelComp:
-        *threshold1Param = -25.0f;
-        *ratio1Param = 6.0f;
-        *attack1Param = 10.0f;
-        *release1Param = 120.0f;
-        *dualStageParam = true;
-        *threshold2Param = -10.0f;
-        *ratio2Param = 10.0f;
-        *attack2Param = 2.0f;
-        *release2Param = 50.0f;
-        *autoMakeupParam = true;
-        *mixParam = 30.0f;
-        *kneeParam = 6.0f;
-        break;
-
-    default:
-        break;
-    }
+        return preset != nullptr ? preset->valueOf(rawValue) : rawValue->load();
+    };
+
+    parameters.threshold1 = value(threshold1Param);
+    parameters.ratio1 = value(ratio1Param);
+    parameters.attack1 = value(attack1Param);
+    parameters.release1 = getReleaseMs(value(release1Param), value(releaseSync1Param));
+    parameters.knee = value(kneeParam);
+    parameters.sidechainHPF1 = value(sidechainHPF1Param);
+    parameters.sidechainSlope1 = static_cast<MixCompressorDSP::CompressorStage::SidechainSlope>(static_cast<int>(value(sidechainSlope1Param)));
+
+    parameters.dualStage = value(dualStageParam) > 0.5f;
+    parameters.threshold2 = value(threshold2Param);
+    parameters.ratio2 = value(ratio2Param);
+    parameters.attack2 = value(attack2Param);
+    parameters.release2 = getReleaseMs(value(release2Param), value(releaseSync2Param));
+    parameters.sidechainHPF2 = value(sidechainHPF2Param);
+    parameters.sidechainSlope2 = static_cast<MixCompressorDSP::CompressorStage::SidechainSlope>(static_cast<int>(value(sidechainSlope2Param)));
+
+    parameters.crossover1 = value(crossover1Param);
+    parameters.crossover2 = value(crossover2Param);
+    parameters.crossover3 = value(crossover3Param);
+
+    parameters.makeupDB = value(makeupParam);
+    parameters.autoMakeup = value(autoMakeupParam) > 0.5f;
+    parameters.mixPercent = value(mixParam);
+    parameters.linkMode = static_cast<MixCompressorDSP::LinkMode>(static_cast<int>(value(stereoLinkParam)));
+    parameters.clipMode = static_cast<MixCompressorDSP::SoftClipper::Mode>(static_cast<int>(value(clipModeParam)));
+    parameters.topology = static_cast<MixCompressorDSP::Topology>(static_cast<int>(value(topologyParam)));
 }
 
-//==============================================================================
-// Compressor Stage Implementation with improved smoothing
-void MixCompressorAudioProcessor::CompressorStage::prepare(double sr)
+float MixCompressorAudioProcessor::getReleaseMs(float freeMs, float syncChoice) const noexcept
 {
-    sampleRate = sr;
-    reset();
+    // Quarter notes per choice; "Free" uses the release knob as is
+    static constexpr double beats[] = { 0.0, 2.0, 1.0, 0.5, 0.25, 0.125 };
+    auto choice = juce::jlimit(0, static_cast<int>(std::size(beats)) - 1, static_cast<int>(syncChoice));
+
+    if (choice == 0)
+        return freeMs;
+
+    // The stage only recomputes its coefficients when this changes, and glides
+    // to the new time, so tempo ramps don't step the gain
+    return juce::jlimit(1.0f, 10000.0f, static_cast<float>(beats[choice] * 60000.0 / hostBpm));
 }
 
-void MixCompressorAudioProcessor::CompressorStage::setParameters(float threshold, float r, float attack, float release, float knee)
+void MixCompressorAudioProcessor::updateLinkGroupTable()
 {
-    thresholdDB = threshold;
-    ratio = juce::jmax(1.0f, r); // Ensure ratio is at least 1:1
-    kneeWidth = knee;
+    using ChannelType = juce::AudioChannelSet::ChannelType;
 
-    // Convert attack/release times to coefficients with minimum values to prevent instability
-    float attackMs = juce::jmax(0.1f, attack);
-    float releaseMs = juce::jmax(20.0f, release);
+    auto layout = getBusesLayout().getMainOutputChannelSet();
+    auto numChannels = juce::jmin(layout.size(), maxChannels);
 
-    attackCoef = 1.0f - std::exp(-1.0f / (attackMs * 0.001f * static_cast<float>(sampleRate)));
-    releaseCoef = 1.0f - std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
-
-    // Clamp coefficients to safe range
-    attackCoef = juce::jlimit(0.0001f, 0.9999f, attackCoef);
-    releaseCoef = juce::jlimit(0.0001f, 0.9999f, releaseCoef);
+    // Channels past the layout (or in a discrete one) count as surrounds, so
+    // they link with each other but not with the fronts
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        auto type = channel < numChannels ? layout.getTypeOfChannel(channel) : ChannelType::unknown;
+        auto isLFE = type == ChannelType::LFE || type == ChannelType::LFE2;
+        auto isFront = type == ChannelType::left || type == ChannelType::right || type == ChannelType::centre
+            || type == ChannelType::leftCentre || type == ChannelType::rightCentre
+            || type == ChannelType::wideLeft || type == ChannelType::wideRight;
+
+        linkGroupTable[static_cast<int>(LinkGroupMode::AllChannels)][channel] = 0;
+        linkGroupTable[static_cast<int>(LinkGroupMode::FrontsAndSurrounds)][channel] = isLFE ? -1 : (isFront ? 0 : 1);
+        linkGroupTable[static_cast<int>(LinkGroupMode::AllButLFE)][channel] = isLFE ? -1 : 0;
+    }
 }
 
-float MixCompressorAudioProcessor::CompressorStage::processSample(float input, float& grOut)
+//==============================================================================
+void MixCompressorAudioProcessor::buildPresetSnapshots()
 {
-    // Use absolute value for peak detection
-    float inputAbs = std::fabs(input);
+    static_assert(FactoryPresets::numPresets == static_cast<int>(PresetMode::NumPresets),
+        "one factory preset per PresetMode");
+    static_assert(FactoryPresets::Preset::maxValues < PresetSnapshot::maxSettings,
+        "room for every preset value and the preset choice itself");
 
-    // Peak envelope follower with proper ballistics
-    if (inputAbs > peakEnvelope)
-        peakEnvelope += (inputAbs - peakEnvelope) * attackCoef;
-    else
-        peakEnvelope += (inputAbs - peakEnvelope) * releaseCoef;
+    for (int index = 0; index < FactoryPresets::numPresets; ++index)
+    {
+        auto& snapshot = presetSnapshots[index];
+        snapshot = {};
+
+        auto set = [this, &snapshot](const char* parameterID, float value)
+        {
+            auto* parameter = apvts.getParameter(parameterID);
+            jassert(parameter != nullptr);
 
-    // Clamp envelope to prevent extreme values
-    peakEnvelope = juce::jlimit(0.0f, 10.0f, peakEnvelope);
+            if (parameter == nullptr)
+                return;
 
-    // Convert to dB with safe floor
-    float envDB = juce::Decibels::gainToDecibels(peakEnvelope + 1e-6f);
+            // A later value for the same parameter replaces the earlier one
+            auto* setting = std::find_if(snapshot.settings, snapshot.settings + snapshot.numSettings,
+                [parameter](const PresetSnapshot::Setting& s) { return s.parameter == parameter; });
 
-    // Apply compression curve
-    float gainReductionDB = applyCompressionCurve(envDB);
-    grOut = gainReductionDB;
+            if (setting == snapshot.settings + snapshot.numSettings)
+            {
+                jassert(snapshot.numSettings < PresetSnapshot::maxSettings);
 
-    // Convert back to linear gain
-    float targetGain = juce::Decibels::decibelsToGain(-gainReductionDB);
+                if (snapshot.numSettings == PresetSnapshot::maxSettings)
+                    return;
 
-    // Smooth the gain changes to prevent clicks
-    gainSmooth += (targetGain - gainSmooth) * gainSmoothingCoef;
-    gainSmooth = juce::jlimit(0.01f, 1.0f, gainSmooth);
+                ++snapshot.numSettings;
+            }
 
-    return input * gainSmooth;
+            *setting = { parameter, apvts.getRawParameterValue(parameterID), value };
+        };
+
+        auto& preset = FactoryPresets::presets[index];
+        set("preset", static_cast<float>(index));
+
+        for (int i = 0; i < preset.getNumValues(); ++i)
+            set(preset.values[i].parameterID, preset.values[i].value);
+    }
 }
 
-float MixCompressorAudioProcessor::CompressorStage::applyCompressionCurve(float inputDB)
+void MixCompressorAudioProcessor::loadPreset(PresetMode preset)
 {
-    float overThreshold = inputDB - thresholdDB;
+    MIXCOMP_ASSERT_NOT_REALTIME(Lock);
 
-    if (overThreshold <= -kneeWidth * 0.5f)
-    {
-        // Below knee
-        return 0.0f;
-    }
-    else if (overThreshold >= kneeWidth * 0.5f)
-    {
-        // Above knee - full compression
-        float grDB = overThreshold * (1.0f - 1.0f / ratio);
-        return juce::jlimit(0.0f, 60.0f, grDB); // Clamp to reasonable range
-    }
-    else
+    auto index = static_cast<int>(preset);
+    if (index < 0 || index >= static_cast<int>(PresetMode::NumPresets))
+        return;
+
+    auto& snapshot = presetSnapshots[index];
+
+    // Publish the whole preset first; the next block uses all of it
+    auto generation = (presetState.load() >> presetIndexBits) + 1;
+    auto published = (generation << presetIndexBits) | static_cast<std::uint32_t>(index + 1);
+    presetState.store(published);
+
+    // Then bring the host-facing parameters in line, in one batch of gestures
+    for (int i = 0; i < snapshot.numSettings; ++i)
+        snapshot.settings[i].parameter->beginChangeGesture();
+
+    for (int i = 0; i < snapshot.numSettings; ++i)
     {
-        // In knee - soft transition using quadratic curve
-        float kneeInput = overThreshold + kneeWidth * 0.5f;
-        float kneeFactor = (kneeInput * kneeInput) / (2.0f * kneeWidth);
-        float grDB = kneeFactor * (1.0f - 1.0f / ratio);
-        return juce::jlimit(0.0f, 60.0f, grDB);
+        auto& setting = snapshot.settings[i];
+        setting.parameter->setValueNotifyingHost(setting.parameter->convertTo0to1(setting.value));
     }
-}
 
-void MixCompressorAudioProcessor::CompressorStage::reset()
-{
-    peakEnvelope = 0.0f;
-    gainSmooth = 1.0f;
+    for (int i = 0; i < snapshot.numSettings; ++i)
+        snapshot.settings[i].parameter->endChangeGesture();
+
+    // The parameters hold the preset now. Keep the generation, so a block
+    // that missed the snapshot still crossfades; a preset loaded meanwhile
+    // (the editor reacting to the "preset" change) retires its own.
+    presetState.compare_exchange_strong(published, generation << presetIndexBits);
 }
 
 //==============================================================================
@@ -498,13 +611,19 @@ juce::AudioProcessorEditor* MixCompressorAudioProcessor::createEditor()
 //==============================================================================
 void MixCompressorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    MIXCOMP_ASSERT_NOT_REALTIME(Lock);
+
+    PluginState::write(apvts, destData);
 }
 
 void MixCompressorAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    MIXCOMP_ASSERT_NOT_REALTIME(Lock);
+
+    if (PluginState::read(apvts, data, sizeInBytes))
+        return;
+
+    // Sessions saved before the binary format hold the parameter tree as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
@@ -547,7 +666,20 @@ bool MixCompressorAudioProcessor::isMidiEffect() const
 
 double MixCompressorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    using Engine = MixCompressorDSP::CompressorEngine;
+
+    // After the input stops, audio can still be in the longest lookahead and
+    // crossover delays, and the gain then takes the release time to recover.
+    // Before the first block the free release knobs stand in.
+    auto sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    auto maxDelaySeconds = Engine::maxLookaheadMs * 0.001
+        + Engine::crossoverLatencySamples(4, Engine::CrossoverPhase::Linear, sampleRate) / sampleRate;
+
+    auto releaseMs = longestReleaseMs.load();
+    if (releaseMs <= 0.0f && release1Param != nullptr && release2Param != nullptr)
+        releaseMs = juce::jmax(release1Param->load(), release2Param->load());
+
+    return maxDelaySeconds + releaseMs * 0.001;
 }
 
 int MixCompressorAudioProcessor::getNumPrograms()
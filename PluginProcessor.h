@@ -1,9 +1,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DSP/MixCompressorDSP.h"
+#include "LoadProfiler.h"
+#include "MeterRing.h"
+#include "RealtimeSafety.h"
 
 //==============================================================================
-class MixCompressorAudioProcessor : public juce::AudioProcessor
+class MixCompressorAudioProcessor : public juce::AudioProcessor,
+    private juce::AudioProcessorValueTreeState::Listener,
+    private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -19,6 +25,8 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,65 +64,167 @@ public:
         NumPresets
     };
 
+    // Switches every setting of the preset in one go: the audio thread picks
+    // the whole preset up at a block boundary and crossfades into it, then
+    // the host is told about each parameter
     void loadPreset(PresetMode preset);
-    float getCurrentGainReduction() const { return currentGainReduction; }
+
+    // Metering: the editor switches it on while open and drains one frame per block
+    void setMeteringActive(bool shouldBeActive) { meteringActive.store(shouldBeActive); }
+    MeterRing& getMeterRing() { return meterRing; }
+
+    // How many blocks took each processing path (full, silent, dry-only, wet-only)
+    std::uint64_t getProcessingPathCount(MixCompressorDSP::CompressorEngine::ProcessingPath path) const
+    {
+        return isUsingDoublePrecision() ? doubleEngine.getPathCount(path) : engine.getPathCount(path);
+    }
+
+#if MIXCOMP_ENABLE_PROFILING
+    // DSP load per block and per stage, for the editor's overlay
+    LoadProfiler& getLoadProfiler() { return loadProfiler; }
+#endif
 
     // Parameter access
     juce::AudioProcessorValueTreeState& getValueTreeState() { return apvts; }
 
 private:
     //==============================================================================
-    // Compressor engine - single stage with proper smoothing
-    class CompressorStage
+    juce::AudioProcessorValueTreeState apvts;
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Lookahead and the crossover mode change the plugin's latency, which must
+    // be reported to the host from the message thread
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateLatency();
+
+    template <typename SampleType>
+    void applyLatencySettings(MixCompressorDSP::BasicCompressorEngine<SampleType>& target) noexcept;
+
+    // Both processBlock overloads: reads the parameters and runs the engine
+    // matching the host's precision
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, MixCompressorDSP::BasicCompressorEngine<SampleType>& target);
+
+    //==============================================================================
+    // Every value one preset sets. Built once in the constructor and never
+    // changed, so the audio thread can read it while the host-facing
+    // parameters are still being updated.
+    struct PresetSnapshot
     {
-    public:
-        void prepare(double sampleRate);
-        void setParameters(float threshold, float ratio, float attack, float release, float knee);
-        float processSample(float input, float& grOut);
-        void reset();
-
-    private:
-        // Peak detection with proper ballistics
-        float peakEnvelope = 0.0f;
-        float gainSmooth = 1.0f;
-
-        float attackCoef = 0.0f;
-        float releaseCoef = 0.0f;
-        float thresholdDB = -24.0f;
-        float ratio = 4.0f;
-        float kneeWidth = 6.0f;
-        double sampleRate = 44100.0;
-
-        // Gain smoothing to prevent clicks
-        static constexpr float gainSmoothingCoef = 0.9999f;
-
-        float applyCompressionCurve(float inputDB);
+        struct Setting
+        {
+            juce::RangedAudioParameter* parameter = nullptr;
+            const std::atomic<float>* rawValue = nullptr;
+            float value = 0.0f; // in the parameter's own units
+        };
+
+        static constexpr int maxSettings = 16;
+        Setting settings[maxSettings];
+        int numSettings = 0;
+
+        // The preset's value for a parameter, or its current one if the preset leaves it alone
+        float valueOf(const std::atomic<float>* rawValue) const noexcept
+        {
+            for (int i = 0; i < numSettings; ++i)
+                if (settings[i].rawValue == rawValue)
+                    return settings[i].value;
+
+            return rawValue->load();
+        }
     };
 
-    //==============================================================================
-    juce::AudioProcessorValueTreeState apvts;
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void buildPresetSnapshots();
 
-    // Dual-stage compression with independent smoothing
-    CompressorStage stage1; // Leveler
-    CompressorStage stage2; // Peak catcher
+    // Audio thread: the engine parameters, taking the values a preset sets
+    // from its snapshot when one is given
+    void readParameters(MixCompressorDSP::Parameters& parameters, const PresetSnapshot* preset) const noexcept;
 
-    // Metering
-    std::atomic<float> currentGainReduction{ 0.0f };
+    // Release time in ms: the free value, or the chosen note length at the
+    // host's tempo when a release is synced
+    float getReleaseMs(float freeMs, float syncChoice) const noexcept;
 
-    // Auto makeup gain calculation with smoothing
-    float calculateAutoMakeup(float avgGainReduction);
-    juce::SmoothedValue<float> makeupGainSmoothed;
+    // Link group of each channel for every "linkGroups" choice, worked out
+    // from the bus layout in prepareToPlay so processBlock only picks a row
+    void updateLinkGroupTable();
 
-    // RMS calculation for level matching
-    float inputRMS = 0.0f;
-    float outputRMS = 0.0f;
-    static constexpr float rmsAlpha = 0.99f;
+    enum class LinkGroupMode
+    {
+        AllChannels = 0,
+        FrontsAndSurrounds,
+        AllButLFE,
+        NumModes
+    };
+
+    static constexpr int maxChannels = MixCompressorDSP::CompressorEngine::maxChannels;
+    int linkGroupTable[static_cast<int>(LinkGroupMode::NumModes)][maxChannels] = {};
+    int appliedLinkGroupMode = -1;
+
+    // Raw parameter values, looked up once so processBlock doesn't search by ID
+    std::atomic<float>* threshold1Param = nullptr;
+    std::atomic<float>* ratio1Param = nullptr;
+    std::atomic<float>* attack1Param = nullptr;
+    std::atomic<float>* release1Param = nullptr;
+    std::atomic<float>* releaseSync1Param = nullptr;
+    std::atomic<float>* sidechainHPF1Param = nullptr;
+    std::atomic<float>* sidechainSlope1Param = nullptr;
+    std::atomic<float>* kneeParam = nullptr;
+    std::atomic<float>* dualStageParam = nullptr;
+    std::atomic<float>* threshold2Param = nullptr;
+    std::atomic<float>* ratio2Param = nullptr;
+    std::atomic<float>* attack2Param = nullptr;
+    std::atomic<float>* release2Param = nullptr;
+    std::atomic<float>* releaseSync2Param = nullptr;
+    std::atomic<float>* sidechainHPF2Param = nullptr;
+    std::atomic<float>* sidechainSlope2Param = nullptr;
+    std::atomic<float>* lookahead2Param = nullptr;
+    std::atomic<float>* makeupParam = nullptr;
+    std::atomic<float>* autoMakeupParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* stereoLinkParam = nullptr;
+    std::atomic<float>* linkGroupsParam = nullptr;
+    std::atomic<float>* clipModeParam = nullptr;
+    std::atomic<float>* topologyParam = nullptr;
+    std::atomic<float>* bandsParam = nullptr;
+    std::atomic<float>* crossoverPhaseParam = nullptr;
+    std::atomic<float>* crossover1Param = nullptr;
+    std::atomic<float>* crossover2Param = nullptr;
+    std::atomic<float>* crossover3Param = nullptr;
+
+    // All signal processing lives in the JUCE-independent engine. Only the one
+    // matching the host's processing precision is prepared.
+    MixCompressorDSP::CompressorEngine engine;
+    MixCompressorDSP::BasicCompressorEngine<double> doubleEngine;
+
+    // Tempo from the play head, read once per block. Audio thread only; keeps
+    // the last known value while the host doesn't report one.
+    double hostBpm = 120.0;
+
+    PresetSnapshot presetSnapshots[static_cast<int>(PresetMode::NumPresets)];
+
+    // Preset handover: a generation count above presetIndexBits, and 1 + the
+    // preset's index below them while its parameters are being set. One
+    // atomic, so a block sees the preset and its generation together.
+    static constexpr int presetIndexBits = 8;
+    std::atomic<std::uint32_t> presetState{ 0 };
+    std::uint32_t appliedPresetGeneration = 0; // audio thread only
+
+    // Latency-affecting settings, as last reported to the host
+    std::atomic<int> lookaheadSamples{ 0 };
+    std::atomic<int> numBands{ 1 };
+    std::atomic<bool> linearPhaseCrossover{ false };
+
+    // Longest release time in use, in ms, for getTailLengthSeconds(). Written
+    // once per block; zero until the first one.
+    std::atomic<float> longestReleaseMs{ 0.0f };
 
-    // DC blocker to prevent offset issues
-    float dcBlockerX1[2] = { 0.0f, 0.0f };
-    float dcBlockerY1[2] = { 0.0f, 0.0f };
-    static constexpr float dcBlockerCoef = 0.995f;
+    // Metering
+    MeterRing meterRing;
+    std::atomic<bool> meteringActive{ false };
+
+#if MIXCOMP_ENABLE_PROFILING
+    LoadProfiler loadProfiler;
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixCompressorAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "PluginState.h"
+
+namespace
+{
+    constexpr int headerSize = 8;
+
+    // Schema order. New parameters go at the end with a new currentVersion;
+    // entries are never reordered or removed.
+    const char* const parameterIDs[] = {
+        // Version 1
+        "preset",
+        "threshold1", "ratio1", "attack1", "release1", "releaseSync1", "scFreq1", "scSlope1",
+        "dualStage",
+        "threshold2", "ratio2", "attack2", "release2", "releaseSync2", "scFreq2", "scSlope2", "lookahead2",
+        "makeup", "autoMakeup", "mix", "knee",
+        "stereoLink", "linkGroups", "clipMode", "topology",
+        "bands", "crossoverPhase", "crossover1", "crossover2", "crossover3"
+    };
+
+    constexpr int numParameters = static_cast<int>(std::size(parameterIDs));
+
+    // Converts values saved with an older schema to the current one, in
+    // place. A parameter whose range or meaning changes gets a case for the
+    // last version with the old meaning, falling through to the next one.
+    // Nothing has changed since version 1.
+    void migrate(int fromVersion, float* values, int numValues)
+    {
+        juce::ignoreUnused(fromVersion, values, numValues);
+    }
+}
+
+//==============================================================================
+void PluginState::write(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData)
+{
+    static_assert(numParameters <= 0xffff, "the value count is stored in 16 bits");
+
+    destData.setSize(0);
+    destData.ensureSize(static_cast<size_t>(headerSize + numParameters * 4));
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(magic));
+    stream.writeShort(static_cast<short>(currentVersion));
+    stream.writeShort(static_cast<short>(numParameters));
+
+    for (auto* parameterID : parameterIDs)
+    {
+        auto* parameter = apvts.getParameter(parameterID);
+        jassert(parameter != nullptr);
+
+        stream.writeFloat(parameter != nullptr ? parameter->convertFrom0to1(parameter->getValue()) : 0.0f);
+    }
+}
+
+bool PluginState::read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < headerSize)
+        return false;
+
+    auto* bytes = static_cast<const char*>(data);
+
+    if (juce::ByteOrder::littleEndianInt(bytes) != magic)
+        return false;
+
+    auto version = static_cast<int>(juce::ByteOrder::littleEndianShort(bytes + 4));
+    auto numValues = static_cast<int>(juce::ByteOrder::littleEndianShort(bytes + 6));
+
+    if (version < 1 || sizeInBytes < headerSize + numValues * 4)
+        return false;
+
+    float values[numParameters] = {};
+    auto numKnown = juce::jmin(numValues, numParameters);
+
+    for (int i = 0; i < numKnown; ++i)
+    {
+        auto bits = juce::ByteOrder::littleEndianInt(bytes + headerSize + i * 4);
+        std::memcpy(&values[i], &bits, sizeof(float));
+    }
+
+    migrate(version, values, numKnown);
+
+    // "preset" comes first, so an editor that loads the preset when it
+    // changes can't overwrite the values that follow
+    for (int i = 0; i < numParameters; ++i)
+    {
+        auto* parameter = apvts.getParameter(parameterIDs[i]);
+
+        if (parameter == nullptr)
+            continue;
+
+        auto value = i < numKnown && std::isfinite(values[i]) ? parameter->convertTo0to1(values[i])
+                                                              : parameter->getDefaultValue();
+        parameter->setValueNotifyingHost(value);
+    }
+
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Compact binary plugin state, for hosts that save and load many instances.
+//
+// Layout, little-endian:
+//
+//   uint32  magic ("MCst")
+//   uint16  schema version
+//   uint16  number of values
+//   float   one value per parameter, in its own units, in schema order
+//
+// Reading it is a bounds check and a loop over the values; no XML is built
+// or parsed. The schema only ever grows: a new parameter is appended and the
+// version bumped. A block from an older version holds a prefix of the list,
+// so parameters added since then get their defaults, and values whose
+// meaning changed are migrated on load. A newer block's extra values are
+// ignored.
+//==============================================================================
+namespace PluginState
+{
+    static constexpr juce::uint32 magic = 0x7473434d;
+    static constexpr int currentVersion = 1;
+
+    void write(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData);
+
+    // Returns false, leaving the parameters alone, if data is not a binary
+    // state (e.g. an XML one from an older build)
+    bool read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes);
+}
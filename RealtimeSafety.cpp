@@ -0,0 +1,290 @@
+#include "RealtimeSafety.h"
+
+#if MIXCOMP_REALTIME_CHECKS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    thread_local bool insideAudioCallback = false;
+
+    const char* getViolationName(RealtimeSafety::Violation type) noexcept
+    {
+        switch (type)
+        {
+        case RealtimeSafety::Violation::Allocation:   return "heap allocation";
+        case RealtimeSafety::Violation::Deallocation: return "heap deallocation";
+        case RealtimeSafety::Violation::Lock:         return "lock";
+        case RealtimeSafety::Violation::SystemCall:   return "system call";
+        default:                                      return "unknown";
+        }
+    }
+
+    void checkAllocation(RealtimeSafety::Violation type) noexcept
+    {
+        if (insideAudioCallback)
+            RealtimeSafety::reportViolation(type, "operator new/delete");
+    }
+
+    void* checkedAllocate(std::size_t size)
+    {
+        checkAllocation(RealtimeSafety::Violation::Allocation);
+
+        if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void checkedFree(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+        {
+            checkAllocation(RealtimeSafety::Violation::Deallocation);
+            std::free(ptr);
+        }
+    }
+
+    void* checkedAllocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        checkAllocation(RealtimeSafety::Violation::Allocation);
+
+        auto bytes = static_cast<std::size_t>(alignment);
+        size = size == 0 ? 1 : size;
+
+       #if JUCE_WINDOWS
+        if (auto* ptr = _aligned_malloc(size, bytes))
+            return ptr;
+       #else
+        void* ptr = nullptr;
+
+        if (posix_memalign(&ptr, bytes < sizeof(void*) ? sizeof(void*) : bytes, size) == 0)
+            return ptr;
+       #endif
+
+        throw std::bad_alloc();
+    }
+
+    void checkedFreeAligned(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+        {
+            checkAllocation(RealtimeSafety::Violation::Deallocation);
+
+           #if JUCE_WINDOWS
+            _aligned_free(ptr);
+           #else
+            std::free(ptr);
+           #endif
+        }
+    }
+}
+
+//==============================================================================
+RealtimeSafety::ScopedAudioCallback::ScopedAudioCallback() noexcept
+    : wasInside(insideAudioCallback)
+{
+    insideAudioCallback = true;
+}
+
+RealtimeSafety::ScopedAudioCallback::~ScopedAudioCallback() noexcept
+{
+    insideAudioCallback = wasInside;
+}
+
+bool RealtimeSafety::isInsideAudioCallback() noexcept
+{
+    return insideAudioCallback;
+}
+
+void RealtimeSafety::reportViolation(Violation type, const char* where) noexcept
+{
+    // Leave the audio scope first so that reporting can't recurse into itself
+    insideAudioCallback = false;
+
+    std::fprintf(stderr, "MixCompressor real-time violation: %s in %s\n",
+        getViolationName(type), where != nullptr ? where : "?");
+    std::fflush(stderr);
+
+    jassertfalse;
+    std::abort();
+}
+
+//==============================================================================
+// Replacement global allocator, plain and over-aligned
+void* operator new(std::size_t size) { return checkedAllocate(size); }
+void* operator new[](std::size_t size) { return checkedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocate(size); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr) noexcept { checkedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { checkedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { checkedFree(ptr); }
+
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return checkedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return checkedAllocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocateAligned(size, alignment); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return checkedAllocateAligned(size, alignment); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { checkedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { checkedFreeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { checkedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { checkedFreeAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { checkedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { checkedFreeAligned(ptr); }
+
+//==============================================================================
+// Locks and blocking system calls, on POSIX. An executable that links this
+// file (a test host, the regression harness, the offline renderer) calls these
+// instead of the C library's: each checks the calling thread, then forwards to
+// the C library's own, looked up once with dlsym. That catches std::mutex,
+// std::shared_mutex, condition variables, semaphores, raw reads and writes
+// and sleeps anywhere under processBlock. Calls the C library makes to itself
+// (stdio writing through write(), say), and those of a plugin binary dlopen'ed
+// by a host, still go straight to the originals; there only the
+// MIXCOMP_ASSERT_NOT_REALTIME() checks apply.
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+
+namespace
+{
+    // Resolved lazily into a plain atomic, not a function-local static whose
+    // guard might itself take a lock
+    template <typename Function>
+    Function getOriginal(std::atomic<void*>& original, const char* name) noexcept
+    {
+        auto* address = original.load(std::memory_order_acquire);
+
+        if (address == nullptr)
+        {
+            address = dlsym(RTLD_NEXT, name);
+            original.store(address, std::memory_order_release);
+        }
+
+        return reinterpret_cast<Function>(address);
+    }
+
+    void checkBlockingCall(RealtimeSafety::Violation type, const char* where) noexcept
+    {
+        if (insideAudioCallback)
+            RealtimeSafety::reportViolation(type, where);
+    }
+
+    std::atomic<void*> originalMutexLock { nullptr };
+    std::atomic<void*> originalRwlockRead { nullptr };
+    std::atomic<void*> originalRwlockWrite { nullptr };
+    std::atomic<void*> originalCondWait { nullptr };
+    std::atomic<void*> originalCondTimedWait { nullptr };
+    std::atomic<void*> originalSemWait { nullptr };
+    std::atomic<void*> originalRead { nullptr };
+    std::atomic<void*> originalWrite { nullptr };
+    std::atomic<void*> originalSleep { nullptr };
+    std::atomic<void*> originalUsleep { nullptr };
+    std::atomic<void*> originalNanosleep { nullptr };
+}
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "pthread_mutex_lock");
+        return getOriginal<decltype(&::pthread_mutex_lock)>(originalMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "pthread_rwlock_rdlock");
+        return getOriginal<decltype(&::pthread_rwlock_rdlock)>(originalRwlockRead, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "pthread_rwlock_wrlock");
+        return getOriginal<decltype(&::pthread_rwlock_wrlock)>(originalRwlockWrite, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "pthread_cond_wait");
+        return getOriginal<decltype(&::pthread_cond_wait)>(originalCondWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "pthread_cond_timedwait");
+        return getOriginal<decltype(&::pthread_cond_timedwait)>(originalCondTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::Lock, "sem_wait");
+        return getOriginal<decltype(&::sem_wait)>(originalSemWait, "sem_wait")(semaphore);
+    }
+
+    ssize_t read(int file, void* buffer, size_t size)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::SystemCall, "read");
+        return getOriginal<decltype(&::read)>(originalRead, "read")(file, buffer, size);
+    }
+
+    ssize_t write(int file, const void* buffer, size_t size)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::SystemCall, "write");
+        return getOriginal<decltype(&::write)>(originalWrite, "write")(file, buffer, size);
+    }
+
+    unsigned int sleep(unsigned int seconds)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::SystemCall, "sleep");
+        return getOriginal<decltype(&::sleep)>(originalSleep, "sleep")(seconds);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::SystemCall, "usleep");
+        return getOriginal<decltype(&::usleep)>(originalUsleep, "usleep")(microseconds);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        checkBlockingCall(RealtimeSafety::Violation::SystemCall, "nanosleep");
+        return getOriginal<decltype(&::nanosleep)>(originalNanosleep, "nanosleep")(duration, remaining);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Real-time safety checks for the audio callback.
+//
+// Build with MIXCOMP_REALTIME_CHECKS=1 to replace the global allocator, aligned
+// variants included, with a checking version. Any heap allocation or
+// deallocation made on a thread that is inside a ScopedAudioCallback is reported
+// as a violation and aborts the process, so a regression in processBlock can't
+// go unnoticed in a debug/test session.
+//
+// On POSIX, executables that link RealtimeSafety.cpp (test hosts and the tools)
+// also get checking versions of the mutex, rwlock, condition variable and
+// semaphore waits, read, write and the sleeps, which fail the same way when
+// called from the audio thread. Where those can't be replaced (Windows, or a
+// plugin loaded into a host), code that takes a lock or talks to the OS can
+// call MIXCOMP_ASSERT_NOT_REALTIME() first.
+//
+// With MIXCOMP_REALTIME_CHECKS=0 (the default) everything here compiles away.
+//==============================================================================
+#ifndef MIXCOMP_REALTIME_CHECKS
+#define MIXCOMP_REALTIME_CHECKS 0
+#endif
+
+namespace RealtimeSafety
+{
+    enum class Violation
+    {
+        Allocation = 0,
+        Deallocation,
+        Lock,
+        SystemCall
+    };
+
+#if MIXCOMP_REALTIME_CHECKS
+    // Marks the current thread as running the audio callback for its lifetime.
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept;
+        ~ScopedAudioCallback() noexcept;
+
+    private:
+        bool wasInside;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioCallback)
+    };
+
+    bool isInsideAudioCallback() noexcept;
+    void reportViolation(Violation type, const char* where) noexcept;
+#else
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept {}
+    };
+
+    inline bool isInsideAudioCallback() noexcept { return false; }
+    inline void reportViolation(Violation, const char*) noexcept {}
+#endif
+}
+
+#if MIXCOMP_REALTIME_CHECKS
+#define MIXCOMP_ASSERT_NOT_REALTIME(type) \
+    do { if (RealtimeSafety::isInsideAudioCallback()) \
+        RealtimeSafety::reportViolation(RealtimeSafety::Violation::type, __func__); } while (false)
+#else
+#define MIXCOMP_ASSERT_NOT_REALTIME(type) do {} while (false)
+#endif
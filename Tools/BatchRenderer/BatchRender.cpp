@@ -0,0 +1,220 @@
+#include "BatchRender.h"
+#include "WorkStealingPool.h"
+
+namespace
+{
+    // Overrides whatever the stem object sets; missing properties leave the options alone
+    juce::Result applyStemSettings(const juce::var& settings, const juce::File& baseDirectory,
+        OfflineRender::Options& options)
+    {
+        if (settings.isVoid())
+            return juce::Result::ok();
+
+        if (!settings.isObject())
+            return juce::Result::fail("Stem settings must be a JSON object");
+
+        if (settings.hasProperty("input"))
+            options.inputFile = baseDirectory.getChildFile(settings["input"].toString());
+
+        if (settings.hasProperty("output"))
+            options.outputFile = baseDirectory.getChildFile(settings["output"].toString());
+
+        if (settings.hasProperty("preset"))
+            options.presetName = settings["preset"].toString();
+
+        if (settings.hasProperty("blockSize"))
+            options.blockSize = static_cast<int>(settings["blockSize"]);
+
+        if (settings.hasProperty("bits"))
+            options.outputBitDepth = static_cast<int>(settings["bits"]);
+
+        if (settings.hasProperty("mmap"))
+            options.useMemoryMapping = static_cast<bool>(settings["mmap"]);
+
+        // A number for a constant tempo, or a map string as for --tempo
+        if (settings.hasProperty("tempo") && !OfflineRender::parseTempoMap(settings["tempo"].toString(), options.tempoMap))
+            return juce::Result::fail("Bad \"tempo\": " + settings["tempo"].toString());
+
+        auto parameters = settings["parameters"];
+
+        if (!parameters.isVoid())
+        {
+            auto* object = parameters.getDynamicObject();
+
+            if (object == nullptr)
+                return juce::Result::fail("\"parameters\" must be a JSON object");
+
+            for (auto& parameter : object->getProperties())
+                options.parameters.set(parameter.name.toString(), parameter.value.toString());
+        }
+
+        return juce::Result::ok();
+    }
+}
+
+//==============================================================================
+juce::Result BatchRender::loadManifest(const juce::File& manifestFile, const juce::File& outputDirectory,
+    juce::Array<OfflineRender::Options>& jobs)
+{
+    juce::var manifest;
+    auto parsed = juce::JSON::parse(manifestFile.loadFileAsString(), manifest);
+
+    if (parsed.failed())
+        return juce::Result::fail(manifestFile.getFileName() + ": " + parsed.getErrorMessage());
+
+    auto baseDirectory = manifestFile.getParentDirectory();
+
+    OfflineRender::Options defaults;
+    auto result = applyStemSettings(manifest["defaults"], baseDirectory, defaults);
+
+    if (result.failed())
+        return juce::Result::fail("defaults: " + result.getErrorMessage());
+
+    auto* stems = manifest["stems"].getArray();
+
+    if (stems == nullptr)
+        return juce::Result::fail("The manifest needs a \"stems\" array");
+
+    for (int i = 0; i < stems->size(); ++i)
+    {
+        auto options = defaults;
+        auto& stem = stems->getReference(i);
+        result = applyStemSettings(stem, baseDirectory, options);
+
+        if (result.failed())
+            return juce::Result::fail("stem " + juce::String(i) + ": " + result.getErrorMessage());
+
+        if (!stem.hasProperty("input"))
+            return juce::Result::fail("stem " + juce::String(i) + " has no \"input\"");
+
+        if (!stem.hasProperty("output"))
+        {
+            if (outputDirectory == juce::File())
+                return juce::Result::fail("stem " + juce::String(i) + " has no \"output\" and no output directory was given");
+
+            options.outputFile = outputDirectory.getChildFile(options.inputFile.getFileName());
+        }
+
+        jobs.add(options);
+    }
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::int64 BatchRender::MemoryBudget::acquire(juce::int64 bytes)
+{
+    bytes = juce::jlimit<juce::int64>(0, limit, bytes);
+
+    std::unique_lock<std::mutex> guard(lock);
+    released.wait(guard, [this, bytes] { return inUse + bytes <= limit; });
+    inUse += bytes;
+    return bytes;
+}
+
+void BatchRender::MemoryBudget::release(juce::int64 bytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        inUse -= bytes;
+    }
+
+    released.notify_all();
+}
+
+juce::int64 BatchRender::estimateIOBytes(const OfflineRender::Options& options)
+{
+    constexpr juce::int64 streamingBytes = 1 << 20;
+
+    if (options.useMemoryMapping)
+        return juce::jmax(streamingBytes, options.inputFile.getSize());
+
+    return streamingBytes;
+}
+
+//==============================================================================
+BatchRender::Summary BatchRender::renderAll(const juce::Array<OfflineRender::Options>& jobs, const Settings& settings,
+    std::function<void(const JobReport&)> onJobFinished)
+{
+    Summary summary;
+    summary.numThreads = settings.numThreads > 0 ? settings.numThreads : juce::SystemStats::getNumCpus();
+
+    // Longest renders first, so the batch doesn't end waiting on one big stem
+    std::vector<int> order(static_cast<size_t>(jobs.size()));
+    std::vector<juce::int64> sizes(order.size());
+
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        order[static_cast<size_t>(i)] = i;
+        sizes[static_cast<size_t>(i)] = jobs.getReference(i).inputFile.getSize();
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b)
+        {
+            return sizes[static_cast<size_t>(a)] > sizes[static_cast<size_t>(b)];
+        });
+
+    MemoryBudget budget(settings.memoryLimitBytes);
+    std::mutex reportLock;
+
+    // Everything a worker touches on its own; no locking needed
+    struct WorkerState
+    {
+        juce::AudioBuffer<float> scratch;
+        double busySeconds = 0.0;
+    };
+
+    std::vector<WorkerState> workerStates(static_cast<size_t>(summary.numThreads));
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        WorkStealingPool pool(summary.numThreads);
+
+        for (auto jobIndex : order)
+        {
+            pool.submit([&, jobIndex](int workerIndex)
+                {
+                    auto& options = jobs.getReference(jobIndex);
+                    auto& state = workerStates[static_cast<size_t>(workerIndex)];
+
+                    auto reserved = budget.acquire(estimateIOBytes(options));
+                    auto jobStart = juce::Time::getMillisecondCounterHiRes();
+
+                    JobReport report;
+                    report.jobIndex = jobIndex;
+                    report.workerIndex = workerIndex;
+                    report.result = OfflineRender::renderFile(options, state.scratch);
+
+                    state.busySeconds += (juce::Time::getMillisecondCounterHiRes() - jobStart) * 0.001;
+                    budget.release(reserved);
+
+                    std::lock_guard<std::mutex> guard(reportLock);
+
+                    if (report.result.succeeded)
+                    {
+                        ++summary.numSucceeded;
+                        summary.audioSeconds += report.result.audioSeconds;
+                        summary.channelSamples += report.result.numSamples * report.result.numChannels;
+                    }
+                    else
+                    {
+                        ++summary.numFailed;
+                    }
+
+                    if (onJobFinished)
+                        onJobFinished(report);
+                });
+        }
+
+        pool.waitForAll();
+        summary.numStolen = pool.getNumStolen();
+    }
+
+    summary.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    for (auto& state : workerStates)
+        summary.busySeconds += state.busySeconds;
+
+    return summary;
+}
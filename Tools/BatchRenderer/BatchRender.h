@@ -0,0 +1,93 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include "../OfflineRenderer/OfflineRender.h"
+
+//==============================================================================
+// Renders a whole session of stems in parallel. Every stem gets its own
+// MixCompressorAudioProcessor, and the renders are spread over a
+// work-stealing pool. Largest files go first, each worker reuses one scratch
+// buffer for all of its renders, and a memory budget caps how much file data
+// is mapped at once.
+//
+// The manifest is JSON. Relative paths are resolved against the manifest's
+// directory, and any stem setting may be given once under "defaults":
+//
+//   {
+//     "defaults": { "preset": "Mix Bus Glue", "blockSize": 1024, "bits": 24, "tempo": 120 },
+//     "stems": [
+//       { "input": "drums.wav", "output": "out/drums.wav", "preset": "Drum Punch" },
+//       { "input": "vox.wav", "parameters": { "threshold1": -20, "mix": 80 } }
+//     ]
+//   }
+//
+// A stem without an "output" is written to the output directory under its
+// input file name. "tempo" is a BPM or a map like "0:120,30.5:128" (seconds:bpm),
+// reported to the processor for tempo-synced releases.
+//==============================================================================
+namespace BatchRender
+{
+    juce::Result loadManifest(const juce::File& manifestFile, const juce::File& outputDirectory,
+        juce::Array<OfflineRender::Options>& jobs);
+
+    //==============================================================================
+    // Counting semaphore over bytes. A request larger than the whole budget is
+    // clamped to it, so an oversized file runs on its own rather than never.
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget(juce::int64 limitBytes) : limit(juce::jmax<juce::int64>(1, limitBytes)) {}
+
+        juce::int64 acquire(juce::int64 bytes);
+        void release(juce::int64 bytes);
+
+    private:
+        std::mutex lock;
+        std::condition_variable released;
+        juce::int64 limit;
+        juce::int64 inUse = 0;
+    };
+
+    // File data a render keeps resident: the whole input when it is
+    // memory-mapped, otherwise just the reader and writer buffers
+    juce::int64 estimateIOBytes(const OfflineRender::Options& options);
+
+    //==============================================================================
+    struct Settings
+    {
+        int numThreads = 0;                          // 0 = one per core
+        juce::int64 memoryLimitBytes = 1024LL << 20; // mapped input data in flight
+    };
+
+    struct JobReport
+    {
+        int jobIndex = 0;
+        int workerIndex = 0;
+        OfflineRender::Result result;
+    };
+
+    struct Summary
+    {
+        int numSucceeded = 0;
+        int numFailed = 0;
+        int numThreads = 0;
+        juce::uint64 numStolen = 0;
+
+        double audioSeconds = 0.0;       // summed over all stems
+        juce::int64 channelSamples = 0;  // samples processed, all channels
+        double wallSeconds = 0.0;
+        double busySeconds = 0.0;        // summed over all workers
+
+        double getRealtimeFactor() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+        double getSamplesPerSecond() const { return wallSeconds > 0.0 ? static_cast<double>(channelSamples) / wallSeconds : 0.0; }
+        double getUtilisation() const { return wallSeconds > 0.0 && numThreads > 0 ? busySeconds / (wallSeconds * numThreads) : 0.0; }
+    };
+
+    // Renders every job and waits for them all. onJobFinished is called once
+    // per job, from the worker thread, one call at a time.
+    Summary renderAll(const juce::Array<OfflineRender::Options>& jobs, const Settings& settings,
+        std::function<void(const JobReport&)> onJobFinished);
+}
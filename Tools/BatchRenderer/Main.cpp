@@ -0,0 +1,108 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "BatchRender.h"
+
+//==============================================================================
+// Batch renderer: runs every stem in a manifest through its own compressor
+// instance, using all cores.
+//
+//   MixCompressorBatch <manifest.json> [options]
+//
+//   --threads <n>          worker threads (default: one per core)
+//   --memory-mb <n>        cap on memory-mapped input data in flight (default 1024)
+//   --output-dir <dir>     where stems without an "output" are written
+//
+// See BatchRender.h for the manifest format.
+//==============================================================================
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: MixCompressorBatch <manifest.json> [--threads <n>] [--memory-mb <n>]"
+                  << " [--output-dir <dir>]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    BatchRender::Settings settings;
+    juce::File outputDirectory;
+    juce::StringArray positional;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto& arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--threads" && hasValue)
+            settings.numThreads = args[++i].getIntValue();
+        else if (arg == "--memory-mb" && hasValue)
+            settings.memoryLimitBytes = args[++i].getLargeIntValue() << 20;
+        else if (arg == "--output-dir" && hasValue)
+            outputDirectory = cwd.getChildFile(args[++i]);
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        else if (arg.startsWith("--"))
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        else
+            positional.add(arg);
+    }
+
+    if (positional.size() != 1)
+    {
+        printUsage();
+        return 1;
+    }
+
+    juce::Array<OfflineRender::Options> jobs;
+    auto loaded = BatchRender::loadManifest(cwd.getChildFile(positional[0]), outputDirectory, jobs);
+
+    if (loaded.failed())
+    {
+        std::cerr << "Error: " << loaded.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    if (outputDirectory != juce::File())
+        outputDirectory.createDirectory();
+
+    for (auto& job : jobs)
+        job.outputFile.getParentDirectory().createDirectory();
+
+    auto summary = BatchRender::renderAll(jobs, settings, [&jobs](const BatchRender::JobReport& report)
+        {
+            auto& job = jobs.getReference(report.jobIndex);
+
+            if (report.result.succeeded)
+                std::cout << "[" << report.workerIndex << "] " << job.inputFile.getFileName() << ": "
+                          << juce::String(report.result.audioSeconds, 1) << " s at "
+                          << juce::String(report.result.getRealtimeFactor(), 1) << "x realtime" << std::endl;
+            else
+                std::cerr << "[" << report.workerIndex << "] " << job.inputFile.getFileName() << ": "
+                          << report.result.errorMessage << std::endl;
+        });
+
+    std::cout << "Rendered " << summary.numSucceeded << " of " << jobs.size() << " stems ("
+              << juce::String(summary.audioSeconds, 1) << " s of audio) in "
+              << juce::String(summary.wallSeconds, 2) << " s on " << summary.numThreads << " threads: "
+              << juce::String(summary.getRealtimeFactor(), 1) << "x realtime, "
+              << juce::String(summary.getSamplesPerSecond() / 1.0e6, 2) << " M samples/s, "
+              << juce::String(summary.getUtilisation() * 100.0, 0) << "% busy, "
+              << summary.numStolen << " stolen" << std::endl;
+
+    return summary.numFailed == 0 ? 0 : 1;
+}
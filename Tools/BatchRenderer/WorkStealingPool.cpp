@@ -0,0 +1,120 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int numThreads)
+{
+    auto count = numThreads > 0 ? numThreads : 1;
+
+    for (int i = 0; i < count; ++i)
+        workers.push_back(std::make_unique<Worker>());
+
+    // Start the threads only once every queue exists, so stealing is safe
+    for (int i = 0; i < count; ++i)
+        workers[static_cast<size_t>(i)]->thread = std::thread([this, i] { run(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        stopping = true;
+    }
+
+    workAvailable.notify_all();
+
+    for (auto& worker : workers)
+        worker->thread.join();
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    auto& worker = *workers[static_cast<size_t>(nextWorker)];
+    nextWorker = (nextWorker + 1) % getNumWorkers();
+
+    {
+        std::lock_guard<std::mutex> lock(worker.lock);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        ++numQueued;
+        ++numPending;
+    }
+
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::waitForAll()
+{
+    std::unique_lock<std::mutex> lock(stateLock);
+    allDone.wait(lock, [this] { return numPending == 0; });
+}
+
+//==============================================================================
+void WorkStealingPool::run(int workerIndex)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateLock);
+            workAvailable.wait(lock, [this] { return stopping || numQueued > 0; });
+
+            if (numQueued == 0)
+                return; // stopping with nothing left to do
+
+            --numQueued;
+        }
+
+        // A task is reserved for us; it's either in our queue or someone else's
+        Task task;
+
+        while (!popLocal(workerIndex, task) && !steal(workerIndex, task))
+            std::this_thread::yield();
+
+        task(workerIndex);
+
+        bool finished;
+
+        {
+            std::lock_guard<std::mutex> lock(stateLock);
+            finished = --numPending == 0;
+        }
+
+        if (finished)
+            allDone.notify_all();
+    }
+}
+
+bool WorkStealingPool::popLocal(int workerIndex, Task& task)
+{
+    auto& worker = *workers[static_cast<size_t>(workerIndex)];
+    std::lock_guard<std::mutex> lock(worker.lock);
+
+    if (worker.tasks.empty())
+        return false;
+
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thiefIndex, Task& task)
+{
+    auto numWorkers = getNumWorkers();
+
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        auto& victim = *workers[static_cast<size_t>((thiefIndex + offset) % numWorkers)];
+        std::lock_guard<std::mutex> lock(victim.lock);
+
+        if (victim.tasks.empty())
+            continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        ++numStolen;
+        return true;
+    }
+
+    return false;
+}
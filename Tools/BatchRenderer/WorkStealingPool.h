@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+// Thread pool where every worker owns a task queue. Workers take from their
+// own queue and, when it runs dry, steal from the others', so a few long stems
+// can't leave the rest of the machine idle.
+//
+// Queues are first-in first-out for owners and thieves alike: submit the
+// longest tasks first and every worker always picks up the longest task it
+// can find, which keeps the tail of a batch short.
+//
+// Tasks receive the index of the worker running them, which callers use to
+// look up per-thread scratch storage.
+//==============================================================================
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void(int workerIndex)>;
+
+    explicit WorkStealingPool(int numThreads);
+    ~WorkStealingPool();
+
+    int getNumWorkers() const noexcept { return static_cast<int>(workers.size()); }
+
+    // Queues a task, spreading submissions round-robin across the workers
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void waitForAll();
+
+    // Tasks that ran on a worker other than the one they were queued on
+    std::uint64_t getNumStolen() const noexcept { return numStolen.load(); }
+
+private:
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void run(int workerIndex);
+    bool popLocal(int workerIndex, Task& task);
+    bool steal(int thiefIndex, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    int nextWorker = 0;
+
+    std::mutex stateLock;
+    std::condition_variable workAvailable, allDone;
+    int numQueued = 0;   // guarded by stateLock
+    int numPending = 0;  // queued or running, guarded by stateLock
+    bool stopping = false;
+
+    std::atomic<std::uint64_t> numStolen{ 0 };
+};
@@ -0,0 +1,490 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include <numeric>
+#include "TestSignals.h"
+#include "../../PluginProcessor.h"
+#include "../../DSP/CycleCounter.h"
+
+//==============================================================================
+// Microbenchmark for the processBlock hot path.
+//
+// Sweeps test signal, block size, sample rate, channel count, dual stage and
+// mix, timing every processBlock call. Results are printed as a summary and
+// written as CSV so runs from different releases can be diffed.
+//
+//   MixCompressorBenchmark [--seconds <s>] [--output <file.csv>] [--quick]
+//
+// A second sweep times MixCompressorDSP::CompressorStage::processBlock on its own, without the
+// plugin wrapper, DC blocker or mix stage, once per compressor topology. A third compares the soft clipper
+// modes against the original per-sample std::tanh, with the signal driven 12 dB
+// into the curve. A fourth times CompressorEngine::process once per topology at
+// every block size, since the stage sweep stops at one micro-block.
+//==============================================================================
+namespace
+{
+    namespace CycleCounter = MixCompressorDSP::CycleCounter;
+
+    using TestSignals::Signal;
+    using TestSignals::getSignalName;
+    using TestSignals::generateSignal;
+
+    //==============================================================================
+    struct Stats
+    {
+        double p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0, mean = 0.0;
+    };
+
+    Stats computeStats(std::vector<double>& values)
+    {
+        Stats stats;
+
+        if (values.empty())
+            return stats;
+
+        std::sort(values.begin(), values.end());
+
+        auto percentile = [&values](double p)
+            {
+                auto index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+                return values[juce::jmin(index, values.size() - 1)];
+            };
+
+        stats.p50 = percentile(0.50);
+        stats.p90 = percentile(0.90);
+        stats.p99 = percentile(0.99);
+        stats.max = values.back();
+        stats.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+        return stats;
+    }
+
+    //==============================================================================
+    struct Config
+    {
+        juce::String target;
+        Signal signal = Signal::Sine;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        int blockSize = 512;
+        bool dualStage = false;
+        float mix = 100.0f;
+    };
+
+    struct Measurement
+    {
+        Stats nsPerSample;
+        Stats cyclesPerSample;
+        juce::String paths; // chunks per engine fast path, processBlock only
+    };
+
+    juce::String describePaths(const MixCompressorAudioProcessor& processor)
+    {
+        using Path = MixCompressorDSP::CompressorEngine::ProcessingPath;
+        const char* names[] = { "full", "silent", "dry", "wet" };
+        juce::StringArray counts;
+
+        for (int path = 0; path < static_cast<int>(Path::NumPaths); ++path)
+            counts.add(juce::String(names[path]) + "=" + juce::String(processor.getProcessingPathCount(static_cast<Path>(path))));
+
+        return counts.joinIntoString(";");
+    }
+
+    void setParameter(MixCompressorAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.getValueTreeState().getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    Measurement measureProcessBlock(const Config& config, const juce::AudioBuffer<float>& input)
+    {
+        MixCompressorAudioProcessor processor;
+
+        auto channelSet = config.numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        processor.setBusesLayout(layout);
+
+        setParameter(processor, "dualStage", config.dualStage ? 1.0f : 0.0f);
+        setParameter(processor, "mix", config.mix);
+
+        processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        juce::AudioBuffer<float> block(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        auto numBlocks = input.getNumSamples() / config.blockSize;
+        auto numWarmupBlocks = numBlocks / 10;
+
+        std::vector<double> nsPerSample, cyclesPerSample;
+        nsPerSample.reserve(static_cast<size_t>(numBlocks));
+        cyclesPerSample.reserve(static_cast<size_t>(numBlocks));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int channel = 0; channel < config.numChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel, b * config.blockSize, config.blockSize);
+
+            auto startNs = CycleCounter::readNanoseconds();
+            auto startCycles = CycleCounter::readCycles();
+
+            processor.processBlock(block, midi);
+
+            auto cycles = CycleCounter::readCycles() - startCycles;
+            auto ns = CycleCounter::readNanoseconds() - startNs;
+
+            if (b >= numWarmupBlocks)
+            {
+                nsPerSample.push_back(static_cast<double>(ns) / config.blockSize);
+                cyclesPerSample.push_back(static_cast<double>(cycles) / config.blockSize);
+            }
+        }
+
+        return { computeStats(nsPerSample), computeStats(cyclesPerSample), describePaths(processor) };
+    }
+
+    template <typename Topology>
+    Measurement measureCompressorStage(const Config& config, const juce::AudioBuffer<float>& input)
+    {
+        MixCompressorDSP::CompressorStage stage;
+        stage.prepare(config.sampleRate);
+        stage.setParameters(-24.0f, 4.0f, 10.0f, 100.0f, 3.0f);
+        stage.setLinkMode(MixCompressorDSP::CompressorStage::LinkMode::Unlinked, config.numChannels);
+
+        constexpr int numLanes = MixCompressorDSP::CompressorStage::numLanes;
+        alignas(16) float frames[MixCompressorDSP::CompressorStage::maxBlockSamples] = {};
+        alignas(16) float gainReduction[MixCompressorDSP::CompressorStage::maxBlockSamples] = {};
+
+        auto blockSize = config.blockSize;
+        auto numBlocks = input.getNumSamples() / blockSize;
+        auto numWarmupBlocks = numBlocks / 10;
+
+        std::vector<double> nsPerSample, cyclesPerSample;
+        nsPerSample.reserve(static_cast<size_t>(numBlocks));
+        cyclesPerSample.reserve(static_cast<size_t>(numBlocks));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                for (int channel = 0; channel < config.numChannels; ++channel)
+                    frames[i * numLanes + channel] = input.getSample(channel, b * blockSize + i);
+
+            auto startNs = CycleCounter::readNanoseconds();
+            auto startCycles = CycleCounter::readCycles();
+
+            stage.processBlock<Topology>(frames, gainReduction, blockSize);
+
+            auto cycles = CycleCounter::readCycles() - startCycles;
+            auto ns = CycleCounter::readNanoseconds() - startNs;
+
+            if (b >= numWarmupBlocks)
+            {
+                nsPerSample.push_back(static_cast<double>(ns) / blockSize);
+                cyclesPerSample.push_back(static_cast<double>(cycles) / blockSize);
+            }
+        }
+
+        return { computeStats(nsPerSample), computeStats(cyclesPerSample) };
+    }
+
+    // The whole engine with one topology on stage 1, as the plugin runs it:
+    // split into micro-blocks, with the DC blocker, makeup and soft clipper
+    Measurement measureEngine(const Config& config, const juce::AudioBuffer<float>& input,
+        MixCompressorDSP::Topology topology)
+    {
+        MixCompressorDSP::Parameters parameters;
+        parameters.threshold1 = -24.0f;
+        parameters.ratio1 = 4.0f;
+        parameters.attack1 = 10.0f;
+        parameters.release1 = 100.0f;
+        parameters.knee = 3.0f;
+        parameters.topology = topology;
+        parameters.dualStage = config.dualStage;
+        parameters.mixPercent = config.mix;
+
+        MixCompressorDSP::CompressorEngine engine;
+        engine.prepare(config.sampleRate, config.blockSize, config.numChannels);
+        engine.setParameters(parameters);
+        engine.reset();
+
+        auto blockSize = config.blockSize;
+        auto numBlocks = input.getNumSamples() / blockSize;
+        auto numWarmupBlocks = numBlocks / 10;
+        juce::AudioBuffer<float> block(config.numChannels, blockSize);
+
+        std::vector<double> nsPerSample, cyclesPerSample;
+        nsPerSample.reserve(static_cast<size_t>(numBlocks));
+        cyclesPerSample.reserve(static_cast<size_t>(numBlocks));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int channel = 0; channel < config.numChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel, b * blockSize, blockSize);
+
+            auto startNs = CycleCounter::readNanoseconds();
+            auto startCycles = CycleCounter::readCycles();
+
+            engine.process(block.getArrayOfWritePointers(), config.numChannels, blockSize);
+
+            auto cycles = CycleCounter::readCycles() - startCycles;
+            auto ns = CycleCounter::readNanoseconds() - startNs;
+
+            if (b >= numWarmupBlocks)
+            {
+                nsPerSample.push_back(static_cast<double>(ns) / blockSize);
+                cyclesPerSample.push_back(static_cast<double>(cycles) / blockSize);
+            }
+        }
+
+        return { computeStats(nsPerSample), computeStats(cyclesPerSample) };
+    }
+
+    // Clipper variants: the original std::tanh loop, or one of the SoftClipper modes
+    Measurement measureSoftClipper(const Config& config, const juce::AudioBuffer<float>& input,
+        bool useReference, MixCompressorDSP::SoftClipper::Mode mode)
+    {
+        MixCompressorDSP::SoftClipper clipper;
+        clipper.prepare(config.numChannels);
+        clipper.setMode(mode);
+
+        juce::AudioBuffer<float> block(config.numChannels, config.blockSize);
+
+        auto numBlocks = input.getNumSamples() / config.blockSize;
+        auto numWarmupBlocks = numBlocks / 10;
+
+        std::vector<double> nsPerSample, cyclesPerSample;
+        nsPerSample.reserve(static_cast<size_t>(numBlocks));
+        cyclesPerSample.reserve(static_cast<size_t>(numBlocks));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int channel = 0; channel < config.numChannels; ++channel)
+            {
+                block.copyFrom(channel, 0, input, channel, b * config.blockSize, config.blockSize);
+                block.applyGain(channel, 0, config.blockSize, 4.0f);
+            }
+
+            auto startNs = CycleCounter::readNanoseconds();
+            auto startCycles = CycleCounter::readCycles();
+
+            for (int channel = 0; channel < config.numChannels; ++channel)
+            {
+                auto* data = block.getWritePointer(channel);
+
+                if (useReference)
+                {
+                    for (int i = 0; i < config.blockSize; ++i)
+                        data[i] = std::tanh(data[i] * 0.9f) / 0.9f;
+                }
+                else
+                {
+                    clipper.process(data, channel, config.blockSize);
+                }
+            }
+
+            auto cycles = CycleCounter::readCycles() - startCycles;
+            auto ns = CycleCounter::readNanoseconds() - startNs;
+
+            if (b >= numWarmupBlocks)
+            {
+                nsPerSample.push_back(static_cast<double>(ns) / config.blockSize);
+                cyclesPerSample.push_back(static_cast<double>(cycles) / config.blockSize);
+            }
+        }
+
+        return { computeStats(nsPerSample), computeStats(cyclesPerSample) };
+    }
+
+    //==============================================================================
+    juce::String toCsvRow(const Config& config, const Measurement& m)
+    {
+        juce::StringArray fields{
+            config.target, getSignalName(config.signal), juce::String(config.sampleRate, 0),
+            juce::String(config.numChannels), juce::String(config.blockSize),
+            config.dualStage ? "1" : "0", juce::String(config.mix, 0),
+            juce::String(m.nsPerSample.p50, 3), juce::String(m.nsPerSample.p90, 3),
+            juce::String(m.nsPerSample.p99, 3), juce::String(m.nsPerSample.max, 3),
+            juce::String(m.nsPerSample.mean, 3),
+            juce::String(m.cyclesPerSample.p50, 2), juce::String(m.cyclesPerSample.p99, 2),
+            m.paths
+        };
+
+        return fields.joinIntoString(",");
+    }
+
+    const char* csvHeader = "target,signal,sample_rate,channels,block_size,dual_stage,mix,"
+                            "ns_p50,ns_p90,ns_p99,ns_max,ns_mean,cycles_p50,cycles_p99,paths";
+
+    void printRow(const Config& config, const Measurement& m)
+    {
+        std::cout << config.target << " " << getSignalName(config.signal)
+                  << " sr=" << config.sampleRate << " ch=" << config.numChannels
+                  << " bs=" << config.blockSize << " dual=" << (config.dualStage ? "on" : "off")
+                  << " mix=" << config.mix
+                  << " | ns/sample p50 " << juce::String(m.nsPerSample.p50, 2)
+                  << " p99 " << juce::String(m.nsPerSample.p99, 2)
+                  << " max " << juce::String(m.nsPerSample.max, 2);
+
+        if (CycleCounter::hasCycleCounter())
+            std::cout << " | cycles/sample p50 " << juce::String(m.cyclesPerSample.p50, 1);
+
+        if (m.paths.isNotEmpty())
+            std::cout << " | " << m.paths;
+
+        std::cout << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    double seconds = 0.5;
+    bool quick = false;
+    juce::File outputFile = juce::File::getCurrentWorkingDirectory().getChildFile("benchmark_results.csv");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(argv[i]);
+
+        if (arg == "--seconds" && i + 1 < argc)
+            seconds = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--output" && i + 1 < argc)
+            outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--quick")
+            quick = true;
+        else
+        {
+            std::cout << "Usage: MixCompressorBenchmark [--seconds <s>] [--output <file.csv>] [--quick]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    juce::Array<int> blockSizes = quick ? juce::Array<int>{ 32, 512 }
+                                        : juce::Array<int>{ 1, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    juce::Array<double> sampleRates = quick ? juce::Array<double>{ 48000.0 }
+                                            : juce::Array<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+    juce::Array<Signal> signals{ Signal::Silence, Signal::Sine, Signal::PinkNoise, Signal::Transients };
+    juce::Array<float> mixes{ 0.0f, 30.0f, 100.0f };
+
+    juce::StringArray csv;
+    csv.add(csvHeader);
+
+    for (auto sampleRate : sampleRates)
+    {
+        auto numSamples = juce::jmax(4096, static_cast<int>(sampleRate * seconds));
+
+        for (int numChannels = 1; numChannels <= 2; ++numChannels)
+        {
+            juce::AudioBuffer<float> input(numChannels, numSamples);
+
+            for (auto signal : signals)
+            {
+                generateSignal(signal, input, sampleRate);
+
+                for (auto blockSize : blockSizes)
+                {
+                    Config config;
+                    config.signal = signal;
+                    config.sampleRate = sampleRate;
+                    config.numChannels = numChannels;
+                    config.blockSize = blockSize;
+
+                    for (int dual = 0; dual <= 1; ++dual)
+                    {
+                        config.dualStage = dual != 0;
+
+                        for (auto mix : mixes)
+                        {
+                            config.target = "processBlock";
+                            config.mix = mix;
+
+                            auto m = measureProcessBlock(config, input);
+                            printRow(config, m);
+                            csv.add(toCsvRow(config, m));
+                        }
+                    }
+
+                    // The clipper modes against the original std::tanh loop
+                    struct ClipperVariant
+                    {
+                        const char* name;
+                        bool useReference;
+                        MixCompressorDSP::SoftClipper::Mode mode;
+                    };
+
+                    const ClipperVariant clipperVariants[] = {
+                        { "SoftClipper(std::tanh)", true, MixCompressorDSP::SoftClipper::Mode::Fast },
+                        { "SoftClipper(fast)", false, MixCompressorDSP::SoftClipper::Mode::Fast },
+                        { "SoftClipper(adaa)", false, MixCompressorDSP::SoftClipper::Mode::AntiAliased }
+                    };
+
+                    for (auto& variant : clipperVariants)
+                    {
+                        config.target = variant.name;
+                        config.dualStage = false;
+                        config.mix = 100.0f;
+
+                        auto m = measureSoftClipper(config, input, variant.useReference, variant.mode);
+                        printRow(config, m);
+                        csv.add(toCsvRow(config, m));
+                    }
+
+                    // The whole engine per topology, at the host's block size
+                    const std::pair<const char*, MixCompressorDSP::Topology> engineTopologies[] = {
+                        { "CompressorEngine(vca)", MixCompressorDSP::Topology::VCA },
+                        { "CompressorEngine(fet)", MixCompressorDSP::Topology::FET },
+                        { "CompressorEngine(opto)", MixCompressorDSP::Topology::Opto },
+                        { "CompressorEngine(varimu)", MixCompressorDSP::Topology::VariMu }
+                    };
+
+                    for (auto& [name, topology] : engineTopologies)
+                    {
+                        config.target = name;
+                        config.dualStage = false;
+                        config.mix = 100.0f;
+
+                        auto m = measureEngine(config, input, topology);
+                        printRow(config, m);
+                        csv.add(toCsvRow(config, m));
+                    }
+
+                    // The stage on its own, for the same signal and block size.
+                    // It takes at most one micro-block per call.
+                    if (blockSize > MixCompressorDSP::CompressorStage::maxBlockFrames)
+                        continue;
+
+                    config.dualStage = false;
+                    config.mix = 100.0f;
+
+                    using namespace MixCompressorDSP::Topologies;
+                    const std::pair<const char*, Measurement (*)(const Config&, const juce::AudioBuffer<float>&)> topologies[] = {
+                        { "CompressorStage(vca)", measureCompressorStage<VCA> },
+                        { "CompressorStage(fet)", measureCompressorStage<FET> },
+                        { "CompressorStage(opto)", measureCompressorStage<Opto> },
+                        { "CompressorStage(varimu)", measureCompressorStage<VariMu> }
+                    };
+
+                    for (auto& [name, measure] : topologies)
+                    {
+                        config.target = name;
+
+                        auto m = measure(config, input);
+                        printRow(config, m);
+                        csv.add(toCsvRow(config, m));
+                    }
+                }
+            }
+        }
+    }
+
+    if (!outputFile.replaceWithText(csv.joinIntoString("\n") + "\n"))
+    {
+        std::cerr << "Can't write " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results written to " << outputFile.getFullPathName() << std::endl;
+    return 0;
+}
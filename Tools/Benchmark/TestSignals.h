@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+// Deterministic test signals shared by the benchmark and the regression
+// harness. The same signal, sample rate and length always give bit-identical
+// samples, so renders of them can be compared against stored references.
+// No JUCE here, and the noise comes from its own generator, so the references
+// can be recorded by anything that links the DSP core.
+//==============================================================================
+namespace TestSignals
+{
+    enum class Signal
+    {
+        Silence = 0,
+        Sine,
+        PinkNoise,
+        Transients
+    };
+
+    inline const char* getSignalName(Signal signal)
+    {
+        switch (signal)
+        {
+        case Signal::Silence:    return "silence";
+        case Signal::Sine:       return "sine";
+        case Signal::PinkNoise:  return "pink";
+        case Signal::Transients: return "transients";
+        default:                 return "?";
+        }
+    }
+
+    // Linear congruential generator (Numerical Recipes constants); the top
+    // 24 bits give a float in [0, 1) exactly, on every platform
+    class Random
+    {
+    public:
+        explicit Random(std::uint32_t seed) noexcept : state(seed) {}
+
+        float nextFloat() noexcept
+        {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+        }
+
+    private:
+        std::uint32_t state;
+    };
+
+    inline void generateSignal(Signal signal, float* const* channels, int numChannels, int numSamples, double sampleRate)
+    {
+        constexpr float twoPi = 6.283185307f;
+        Random random(1234); // fixed seed so every run sees the same input
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = channels[channel];
+            float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+            float burst = 0.0f;
+            auto hitInterval = static_cast<int>(sampleRate * 0.25); // sixteenths at 60 BPM
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                data[i] = 0.0f;
+
+                switch (signal)
+                {
+                case Signal::Silence:
+                    break;
+
+                case Signal::Sine:
+                    data[i] = 0.5f * std::sin(twoPi * 220.0f * static_cast<float>(i / sampleRate));
+                    break;
+
+                case Signal::PinkNoise:
+                {
+                    // Paul Kellet's economy pink noise filter
+                    float white = random.nextFloat() * 2.0f - 1.0f;
+                    b0 = 0.99765f * b0 + white * 0.0990460f;
+                    b1 = 0.96300f * b1 + white * 0.2965164f;
+                    b2 = 0.57000f * b2 + white * 1.0526913f;
+                    data[i] = 0.15f * (b0 + b1 + b2 + white * 0.1848f);
+                    break;
+                }
+
+                case Signal::Transients:
+                {
+                    // Noise bursts with a fast decay over a low thump
+                    if (i % hitInterval == 0)
+                        burst = 0.9f;
+
+                    burst *= 0.9995f;
+                    float thump = std::sin(twoPi * 60.0f * static_cast<float>((i % hitInterval) / sampleRate));
+                    data[i] = burst * (0.6f * (random.nextFloat() * 2.0f - 1.0f) + 0.4f * thump);
+                    break;
+                }
+                }
+            }
+        }
+    }
+
+    // Any buffer with the juce::AudioBuffer interface
+    template <typename Buffer>
+    void generateSignal(Signal signal, Buffer& buffer, double sampleRate)
+    {
+        generateSignal(signal, buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), sampleRate);
+    }
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../../DSP/FastMath.h"
+
+//==============================================================================
+// Error bounds of the FastMath kernels, without JUCE:
+//
+//   g++ -std=c++17 -O2 -I. Tools/FastMathTest/Main.cpp -o MixCompressorFastMathTest
+//
+// log2     every float from 2^-20 (-120 dB) to 16 (+24 dB), against std::log2,
+//          and gainToDecibels over the same floats against std::log10
+// exp2     a dense sweep of -120..+24 dB plus every float within 64 units in
+//          the last place of each rounding boundary (the half-integers),
+//          against std::exp2, and decibelsToGain against std::pow
+// tanh     a dense sweep of -8..8 against std::tanh
+// arrays   the array kernels (SSE2 where built with it) against the scalar
+//          ones, with odd lengths, unaligned pointers and in place: bit exact
+//
+// The bounds are the ones documented in FastMath.h. The exit code is 0 when
+// every check passes. Built with MIXCOMP_FAST_DB_MATH=0 the dB conversions
+// are exact and only the tanh and array checks mean anything.
+//==============================================================================
+namespace
+{
+    using namespace MixCompressorDSP;
+
+    int numFailed = 0;
+
+    void report(const char* check, double error, double bound)
+    {
+        auto passed = error < bound;
+        numFailed += passed ? 0 : 1;
+        std::cout << (passed ? "PASS " : "FAIL ") << check << " | " << error << " (bound " << bound << ")" << std::endl;
+    }
+
+    float fromBits(std::uint32_t bits)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    std::uint32_t toBits(float x)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    // Every positive float in [from, to]
+    template <typename Function>
+    void forEveryFloat(float from, float to, Function function)
+    {
+        for (auto bits = toBits(from), last = toBits(to); bits <= last; ++bits)
+            function(fromBits(bits));
+    }
+
+    // The dB inputs of the exp2 sweep: a dense grid, and the floats either
+    // side of every point where exp2's rounding to the nearest integer flips
+    std::vector<float> exp2Inputs()
+    {
+        constexpr int numPoints = 1 << 24;
+        std::vector<float> decibels;
+        decibels.reserve(numPoints + 49 * 129);
+
+        for (int i = 0; i < numPoints; ++i)
+            decibels.push_back(-120.0f + 144.0f * static_cast<float>(i) / static_cast<float>(numPoints - 1));
+
+        for (int boundary = -40; boundary <= 8; ++boundary)
+        {
+            auto x = (static_cast<float>(boundary) + 0.5f) * 0.5f; // half-integers of log2 across the dB range
+            auto bits = static_cast<std::int64_t>(toBits(std::abs(x)));
+
+            for (std::int64_t offset = -64; offset <= 64; ++offset)
+            {
+                auto y = std::copysign(fromBits(static_cast<std::uint32_t>(bits + offset)), x);
+                auto dB = y / 0.1660964047f;
+
+                if (dB >= -120.0f && dB <= 24.0f)
+                    decibels.push_back(dB);
+            }
+        }
+
+        return decibels;
+    }
+
+    //==============================================================================
+    void checkLog2()
+    {
+        double log2Error = 0.0, decibelsError = 0.0;
+
+        forEveryFloat(std::ldexp(1.0f, -20), 16.0f, [&](float x)
+        {
+            log2Error = std::max(log2Error, std::abs(static_cast<double>(FastMath::log2(x)) - std::log2(static_cast<double>(x))));
+            decibelsError = std::max(decibelsError,
+                std::abs(static_cast<double>(FastMath::gainToDecibels(x)) - 20.0 * std::log10(static_cast<double>(x))));
+        });
+
+        report("log2 vs std::log2, every float in 2^-20..16", log2Error, 1.2e-5 / 6.020599913);
+        report("gainToDecibels vs std::log10 (dB)", decibelsError, 1.2e-5);
+    }
+
+    void checkExp2()
+    {
+        double exp2Error = 0.0, gainError = 0.0;
+
+        for (auto dB : exp2Inputs())
+        {
+            auto x = dB * 0.1660964047f;
+            auto exact = std::exp2(static_cast<double>(x));
+            exp2Error = std::max(exp2Error, std::abs(static_cast<double>(FastMath::exp2(x)) - exact) / exact);
+
+            auto exactGain = std::pow(10.0, static_cast<double>(dB) / 20.0);
+            gainError = std::max(gainError, std::abs(static_cast<double>(FastMath::decibelsToGain(dB)) - exactGain) / exactGain);
+        }
+
+        report("exp2 vs std::exp2 (relative)", exp2Error, 4.0e-6);
+        report("decibelsToGain vs std::pow (relative)", gainError, 4.0e-6);
+    }
+
+    void checkTanh()
+    {
+        constexpr int numPoints = 1 << 22;
+        double error = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            auto x = -8.0f + 16.0f * static_cast<float>(i) / static_cast<float>(numPoints - 1);
+            error = std::max(error, std::abs(static_cast<double>(FastMath::tanh(x)) - std::tanh(static_cast<double>(x))));
+        }
+
+        report("tanh vs std::tanh", error, 1.1e-4);
+    }
+
+    // Counts the values where an array kernel and its scalar kernel disagree
+    void checkArrays()
+    {
+        auto decibels = exp2Inputs();
+        std::vector<float> gains;
+
+        forEveryFloat(std::ldexp(1.0f, -20), 16.0f, [&](float x)
+        {
+            if ((toBits(x) & 0x3ff) == 0) // every 1024th float keeps this quick
+                gains.push_back(x);
+        });
+
+        std::int64_t numDifferent = 0;
+
+        // Lengths that leave every possible tail, from unaligned starts
+        for (int start = 0; start < 4; ++start)
+        {
+            for (int tail = 0; tail < 4; ++tail)
+            {
+                auto numToGain = static_cast<int>(decibels.size()) - start - tail;
+                std::vector<float> viaArray(decibels.begin(), decibels.end());
+                FastMath::decibelsToGain(viaArray.data() + start, viaArray.data() + start, numToGain);
+
+                for (int i = start; i < start + numToGain; ++i)
+                    numDifferent += toBits(viaArray[static_cast<size_t>(i)]) != toBits(FastMath::decibelsToGain(decibels[static_cast<size_t>(i)]));
+
+                auto numToDecibels = static_cast<int>(gains.size()) - start - tail;
+                std::vector<float> converted(gains.size());
+                FastMath::gainToDecibels(gains.data() + start, converted.data() + start, numToDecibels);
+
+                for (int i = start; i < start + numToDecibels; ++i)
+                    numDifferent += toBits(converted[static_cast<size_t>(i)]) != toBits(FastMath::gainToDecibels(gains[static_cast<size_t>(i)]));
+            }
+        }
+
+        report(MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2 ? "array (SSE2) vs scalar, values that differ"
+                                                             : "array (plain loop) vs scalar, values that differ",
+            static_cast<double>(numDifferent), 1.0);
+    }
+}
+
+//==============================================================================
+int main()
+{
+    checkLog2();
+    checkExp2();
+    checkTanh();
+    checkArrays();
+
+    std::cout << (numFailed == 0 ? "all passed" : "some failed") << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "OfflineRender.h"
+
+//==============================================================================
+// Command-line renderer: runs a WAV/AIFF file through the compressor without a
+// host or editor, faster than real time.
+//
+//   MixCompressorRender input.wav output.wav [options]
+//
+//   --preset <name>        load a preset, e.g. "Drum Punch" or DrumPunch
+//   --param <id>=<value>   set a parameter in its own units, e.g. threshold1=-18
+//   --block-size <n>       samples per processBlock call (default 512)
+//   --bits <n>             output bit depth (default: same as input)
+//   --tempo <map>          host tempo for synced releases: 120, or 0:120,30.5:128
+//   --no-mmap              stream the input instead of memory-mapping it
+//==============================================================================
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: MixCompressorRender <input> <output> [--preset <name>] [--param <id>=<value>]..."
+                  << " [--block-size <n>] [--bits <n>] [--tempo <bpm | seconds:bpm,...>] [--no-mmap]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    OfflineRender::Options options;
+    juce::StringArray positional;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto& arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--preset" && hasValue)
+            options.presetName = args[++i];
+        else if (arg == "--param" && hasValue)
+        {
+            auto assignment = args[++i];
+            options.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (arg == "--block-size" && hasValue)
+            options.blockSize = args[++i].getIntValue();
+        else if (arg == "--bits" && hasValue)
+            options.outputBitDepth = args[++i].getIntValue();
+        else if (arg == "--tempo" && hasValue)
+        {
+            if (!OfflineRender::parseTempoMap(args[++i], options.tempoMap))
+            {
+                std::cerr << "Bad tempo map: " << args[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--no-mmap")
+            options.useMemoryMapping = false;
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        else if (arg.startsWith("--"))
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        else
+            positional.add(arg);
+    }
+
+    if (positional.size() != 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    options.inputFile = cwd.getChildFile(positional[0]);
+    options.outputFile = cwd.getChildFile(positional[1]);
+
+    auto result = OfflineRender::renderFile(options);
+
+    if (!result.succeeded)
+    {
+        std::cerr << "Error: " << result.errorMessage << std::endl;
+        return 1;
+    }
+
+    std::cout << "Rendered " << juce::String(result.audioSeconds, 2) << " s of audio ("
+              << result.numChannels << " ch, " << result.sampleRate << " Hz) in "
+              << juce::String(result.renderSeconds, 3) << " s: "
+              << juce::String(result.getRealtimeFactor(), 1) << "x realtime" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "OfflineRender.h"
+
+namespace
+{
+    std::unique_ptr<juce::AudioFormatReader> createReader(juce::AudioFormatManager& formatManager,
+        const juce::File& file, bool useMemoryMapping)
+    {
+        if (useMemoryMapping)
+        {
+            if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+            {
+                // Mapping the file leaves paging to the OS instead of reading it into RAM
+                std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+
+                if (mapped != nullptr && mapped->mapEntireFile())
+                    return mapped;
+            }
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> createWriter(juce::AudioFormatManager& formatManager,
+        const juce::File& file, double sampleRate, int numChannels, int bitDepth)
+    {
+        auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+
+        if (format == nullptr)
+            return {};
+
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return {};
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+            static_cast<unsigned int>(numChannels), bitDepth, {}, 0));
+
+        // The writer owns the stream once it has been created
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+
+    // Reports the render position and the tempo map's tempo there, so synced
+    // parameters behave the same on every render
+    class TempoMapPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        TempoMapPlayHead(const juce::Array<OfflineRender::TempoChange>& map, double rate)
+            : tempoMap(map), sampleRate(rate)
+        {
+        }
+
+        void setPosition(juce::int64 newPosition) noexcept { position = newPosition; }
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            auto seconds = static_cast<double>(position) / sampleRate;
+
+            info.setTimeInSamples(position);
+            info.setTimeInSeconds(seconds);
+            info.setIsPlaying(true);
+
+            if (!tempoMap.isEmpty())
+            {
+                auto bpm = tempoMap.getReference(0).bpm;
+
+                for (auto& change : tempoMap)
+                    if (change.seconds <= seconds)
+                        bpm = change.bpm;
+
+                info.setBpm(bpm);
+            }
+
+            return info;
+        }
+
+    private:
+        const juce::Array<OfflineRender::TempoChange>& tempoMap;
+        double sampleRate;
+        juce::int64 position = 0;
+    };
+}
+
+//==============================================================================
+bool OfflineRender::applyPreset(MixCompressorAudioProcessor& processor, const juce::String& presetName)
+{
+    auto* presetParam = dynamic_cast<juce::AudioParameterChoice*>(processor.getValueTreeState().getParameter("preset"));
+
+    if (presetParam == nullptr)
+        return false;
+
+    auto wanted = presetName.removeCharacters(" ");
+
+    for (int i = 0; i < presetParam->choices.size(); ++i)
+    {
+        if (presetParam->choices[i].removeCharacters(" ").equalsIgnoreCase(wanted))
+        {
+            processor.loadPreset(static_cast<MixCompressorAudioProcessor::PresetMode>(i));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool OfflineRender::applyParameter(MixCompressorAudioProcessor& processor, const juce::String& parameterID, const juce::String& value)
+{
+    auto* param = processor.getValueTreeState().getParameter(parameterID);
+
+    if (param == nullptr)
+        return false;
+
+    float realValue = value.getFloatValue();
+
+    if (value.equalsIgnoreCase("on") || value.equalsIgnoreCase("true"))
+        realValue = 1.0f;
+    else if (value.equalsIgnoreCase("off") || value.equalsIgnoreCase("false"))
+        realValue = 0.0f;
+
+    param->setValueNotifyingHost(param->convertTo0to1(realValue));
+    return true;
+}
+
+bool OfflineRender::parseTempoMap(const juce::String& spec, juce::Array<TempoChange>& tempoMap)
+{
+    tempoMap.clearQuick();
+
+    for (auto& entry : juce::StringArray::fromTokens(spec, ",", {}))
+    {
+        entry = entry.trim();
+
+        TempoChange change;
+
+        if (entry.contains(":"))
+        {
+            change.seconds = entry.upToFirstOccurrenceOf(":", false, false).trim().getDoubleValue();
+            change.bpm = entry.fromFirstOccurrenceOf(":", false, false).trim().getDoubleValue();
+        }
+        else
+        {
+            change.bpm = entry.getDoubleValue();
+        }
+
+        if (change.bpm <= 0.0 || change.seconds < 0.0)
+            return false;
+
+        tempoMap.add(change);
+    }
+
+    std::stable_sort(tempoMap.begin(), tempoMap.end(),
+        [](const TempoChange& a, const TempoChange& b) { return a.seconds < b.seconds; });
+
+    return !tempoMap.isEmpty();
+}
+
+//==============================================================================
+OfflineRender::Result OfflineRender::renderFile(const Options& options)
+{
+    juce::AudioBuffer<float> buffer;
+    return renderFile(options, buffer);
+}
+
+OfflineRender::Result OfflineRender::renderFile(const Options& options, juce::AudioBuffer<float>& buffer)
+{
+    Result result;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto reader = createReader(formatManager, options.inputFile, options.useMemoryMapping);
+
+    if (reader == nullptr)
+    {
+        result.errorMessage = "Can't read " + options.inputFile.getFullPathName();
+        return result;
+    }
+
+    result.numChannels = static_cast<int>(reader->numChannels);
+    result.sampleRate = reader->sampleRate;
+    result.numSamples = reader->lengthInSamples;
+
+    if (result.numChannels < 1 || result.numChannels > MixCompressorDSP::CompressorEngine::maxChannels)
+    {
+        result.errorMessage = "Only files with 1 to " + juce::String(MixCompressorDSP::CompressorEngine::maxChannels)
+            + " channels are supported";
+        return result;
+    }
+
+    auto blockSize = juce::jmax(1, options.blockSize);
+    auto bitDepth = options.outputBitDepth > 0 ? options.outputBitDepth : static_cast<int>(reader->bitsPerSample);
+
+    auto writer = createWriter(formatManager, options.outputFile, result.sampleRate, result.numChannels, bitDepth);
+
+    if (writer == nullptr)
+    {
+        result.errorMessage = "Can't write " + options.outputFile.getFullPathName();
+        return result;
+    }
+
+    // Set up the processor exactly as a host would, minus the editor
+    MixCompressorAudioProcessor processor;
+
+    // Use the file's own speaker layout where it has one, so link groups
+    // can tell the LFE and surrounds apart
+    auto channelSet = reader->getChannelLayout();
+
+    if (channelSet.size() != result.numChannels)
+        channelSet = juce::AudioChannelSet::canonicalChannelSet(result.numChannels);
+
+    if (channelSet.size() != result.numChannels)
+        channelSet = juce::AudioChannelSet::discreteChannels(result.numChannels);
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (!processor.setBusesLayout(layout))
+    {
+        result.errorMessage = "Processor rejected the channel layout";
+        return result;
+    }
+
+    if (options.presetName.isNotEmpty() && !applyPreset(processor, options.presetName))
+    {
+        result.errorMessage = "Unknown preset: " + options.presetName;
+        return result;
+    }
+
+    for (auto& parameterID : options.parameters.getAllKeys())
+    {
+        if (!applyParameter(processor, parameterID, options.parameters[parameterID]))
+        {
+            result.errorMessage = "Unknown parameter: " + parameterID;
+            return result;
+        }
+    }
+
+    TempoMapPlayHead playHead(options.tempoMap, result.sampleRate);
+    processor.setPlayHead(&playHead);
+
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(result.sampleRate, blockSize);
+    processor.prepareToPlay(result.sampleRate, blockSize);
+
+    // One block of audio is all the memory the render needs
+    buffer.setSize(result.numChannels, blockSize, false, false, true);
+    juce::MidiBuffer midi;
+
+    // Run the latency's worth of silence past the end and drop the same amount
+    // from the start, so the output lines up with the input
+    result.latencySamples = processor.getLatencySamples();
+    auto totalSamples = result.numSamples + result.latencySamples;
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+    {
+        auto numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalSamples - position));
+        buffer.setSize(result.numChannels, numSamples, false, false, true);
+
+        // Reads past the end of the file come back as silence
+        reader->read(&buffer, 0, numSamples, position, true, true);
+        playHead.setPosition(position);
+        processor.processBlock(buffer, midi);
+
+        auto skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, result.latencySamples - position));
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip))
+        {
+            result.errorMessage = "Write failed at sample " + juce::String(position);
+            return result;
+        }
+    }
+
+    writer->flush();
+    processor.releaseResources();
+    processor.setPlayHead(nullptr);
+
+    result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    result.audioSeconds = static_cast<double>(result.numSamples) / result.sampleRate;
+    result.succeeded = true;
+    return result;
+}
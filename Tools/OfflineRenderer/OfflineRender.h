@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../PluginProcessor.h"
+
+//==============================================================================
+// Headless rendering of an audio file through MixCompressorAudioProcessor.
+//
+// Files are streamed through processBlock in fixed-size chunks, so memory use
+// is bounded by the block size regardless of file length. WAV and AIFF inputs
+// are memory-mapped when possible; other formats fall back to a streaming
+// reader.
+//==============================================================================
+namespace OfflineRender
+{
+    // The tempo from a point in the file onwards, for tempo-synced releases
+    struct TempoChange
+    {
+        double seconds = 0.0;
+        double bpm = 120.0;
+    };
+
+    struct Options
+    {
+        juce::File inputFile;
+        juce::File outputFile;
+
+        int blockSize = 512;
+        int outputBitDepth = 0;      // 0 = same as input
+        bool useMemoryMapping = true;
+
+        juce::String presetName;     // empty = keep defaults
+        juce::StringPairArray parameters; // parameter ID -> value in real units
+
+        // Tempo the processor sees through its play head, sorted by time.
+        // Empty = no tempo reported, so synced releases use 120 BPM.
+        juce::Array<TempoChange> tempoMap;
+    };
+
+    struct Result
+    {
+        bool succeeded = false;
+        juce::String errorMessage;
+
+        juce::int64 numSamples = 0;
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        int latencySamples = 0; // compensated in the written file
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+
+        double getRealtimeFactor() const { return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0; }
+    };
+
+    // Applies a preset by its display name ("Drum Punch") or without spaces ("DrumPunch")
+    bool applyPreset(MixCompressorAudioProcessor& processor, const juce::String& presetName);
+
+    // Sets a parameter from a value in its own units (dB, ms, %, choice index, 0/1)
+    bool applyParameter(MixCompressorAudioProcessor& processor, const juce::String& parameterID, const juce::String& value);
+
+    // Parses "120" (constant) or "0:120,30.5:128" (seconds:bpm pairs) into a
+    // sorted tempo map
+    bool parseTempoMap(const juce::String& spec, juce::Array<TempoChange>& tempoMap);
+
+    Result renderFile(const Options& options);
+
+    // Same, rendering through a caller-owned buffer so repeated renders on one
+    // thread reuse its memory
+    Result renderFile(const Options& options, juce::AudioBuffer<float>& scratch);
+}
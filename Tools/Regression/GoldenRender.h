@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "../../DSP/MixCompressorDSP.h"
+#include "../../FactoryPresets.h"
+#include "../Benchmark/TestSignals.h"
+
+//==============================================================================
+// The golden renders, without JUCE: every factory preset turned into engine
+// parameters the way the plugin reads them, run through a CompressorEngine
+// prepared and fed like the plugin in a host. The regression harness checks
+// these against the references in Tools/Regression/References, and its
+// "wrapper" check holds the plugin to the same output, so anything that
+// links the DSP core can record new references.
+//==============================================================================
+namespace GoldenRender
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numChannels = 2;
+    constexpr int numSamples = 48000; // one second, four transient hits
+
+    // File-name form of each factory preset, in FactoryPresets order
+    inline const char* getPresetName(int presetIndex)
+    {
+        static const char* const names[] = { "Manual", "VocalLeveler", "DrumPunch", "BassControl", "MixBusGlue", "ParallelComp" };
+        static_assert(sizeof(names) / sizeof(names[0]) == FactoryPresets::numPresets, "a name per factory preset");
+        return presetIndex >= 0 && presetIndex < FactoryPresets::numPresets ? names[presetIndex] : "?";
+    }
+
+    // Sets the engine parameter behind a plugin parameter ID, converting
+    // choices and switches as the processor does. False for an ID that has no
+    // engine parameter (or isn't known), so a preset can't silently lose one.
+    inline bool applyValue(MixCompressorDSP::Parameters& parameters, const char* parameterID, float value)
+    {
+        using SidechainSlope = MixCompressorDSP::CompressorStage::SidechainSlope;
+        auto is = [parameterID](const char* id) { return std::strcmp(parameterID, id) == 0; };
+
+        if (is("threshold1"))      parameters.threshold1 = value;
+        else if (is("ratio1"))     parameters.ratio1 = value;
+        else if (is("attack1"))    parameters.attack1 = value;
+        else if (is("release1"))   parameters.release1 = value;
+        else if (is("scFreq1"))    parameters.sidechainHPF1 = value;
+        else if (is("scSlope1"))   parameters.sidechainSlope1 = static_cast<SidechainSlope>(static_cast<int>(value));
+        else if (is("dualStage"))  parameters.dualStage = value > 0.5f;
+        else if (is("threshold2")) parameters.threshold2 = value;
+        else if (is("ratio2"))     parameters.ratio2 = value;
+        else if (is("attack2"))    parameters.attack2 = value;
+        else if (is("release2"))   parameters.release2 = value;
+        else if (is("scFreq2"))    parameters.sidechainHPF2 = value;
+        else if (is("scSlope2"))   parameters.sidechainSlope2 = static_cast<SidechainSlope>(static_cast<int>(value));
+        else if (is("crossover1")) parameters.crossover1 = value;
+        else if (is("crossover2")) parameters.crossover2 = value;
+        else if (is("crossover3")) parameters.crossover3 = value;
+        else if (is("makeup"))     parameters.makeupDB = value;
+        else if (is("autoMakeup")) parameters.autoMakeup = value > 0.5f;
+        else if (is("mix"))        parameters.mixPercent = value;
+        else if (is("knee"))       parameters.knee = value;
+        else if (is("stereoLink")) parameters.linkMode = static_cast<MixCompressorDSP::LinkMode>(static_cast<int>(value));
+        else if (is("clipMode"))   parameters.clipMode = static_cast<MixCompressorDSP::SoftClipper::Mode>(static_cast<int>(value));
+        else if (is("topology"))   parameters.topology = static_cast<MixCompressorDSP::Topology>(static_cast<int>(value));
+        else return false;
+
+        return true;
+    }
+
+    // The plugin's defaults with the preset's values on top
+    inline bool getPresetParameters(int presetIndex, MixCompressorDSP::Parameters& parameters)
+    {
+        parameters = {};
+
+        if (presetIndex < 0 || presetIndex >= FactoryPresets::numPresets)
+            return false;
+
+        auto& preset = FactoryPresets::presets[presetIndex];
+
+        for (int i = 0; i < preset.getNumValues(); ++i)
+            if (!applyValue(parameters, preset.values[i].parameterID, preset.values[i].value))
+                return false;
+
+        return true;
+    }
+
+    // Renders a signal through a preset into numChannels channels of
+    // numSamples. False if the preset can't be expressed as engine parameters.
+    inline bool render(int presetIndex, TestSignals::Signal signal, std::vector<std::vector<float>>& channels)
+    {
+        MixCompressorDSP::Parameters parameters;
+
+        if (!getPresetParameters(presetIndex, parameters))
+            return false;
+
+        channels.assign(numChannels, std::vector<float>(static_cast<size_t>(numSamples)));
+        float* pointers[numChannels];
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            pointers[channel] = channels[static_cast<size_t>(channel)].data();
+
+        TestSignals::generateSignal(signal, pointers, numChannels, numSamples, sampleRate);
+
+        MixCompressorDSP::CompressorEngine engine;
+        engine.prepare(sampleRate, blockSize, numChannels);
+        engine.setParameters(parameters);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            float* block[numChannels];
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                block[channel] = pointers[channel] + start;
+
+            engine.process(block, numChannels, std::min(blockSize, numSamples - start));
+        }
+
+        return true;
+    }
+}
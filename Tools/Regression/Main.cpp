@@ -0,0 +1,749 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "GoldenRender.h"
+#include "../../PluginProcessor.h"
+
+//==============================================================================
+// Golden-output regression harness: catches optimizations that change the sound.
+//
+//   MixCompressorRegression <reference dir> [--update] [--ulp <n>] [--floor-db <dB>] [--seconds <s>]
+//
+// golden   Every preset over one second of the sine, pink noise and
+//          transient signals, stereo at 48 kHz in 512-sample blocks, rendered
+//          by GoldenRender.h through the engine, against the stored
+//          <Preset>_<signal>.wav (32-bit float) in the reference directory.
+//          The references are committed in Tools/Regression/References; a
+//          missing one fails. --update writes them instead of checking them.
+// wrapper  The plugin itself, loaded with each preset, against the same
+//          golden render, so the processor can't drift from the engine or
+//          the preset table.
+// splits   The same renders cut into other block sizes, including single
+//          samples, odd sizes and an irregular pattern, against the 512-sample
+//          render. Auto makeup is off here: it follows the peak reduction of
+//          each block the host hands over, so it changes with the block size
+//          by design.
+// lanes    Each channel of a six channel, unlinked engine against a mono
+//          engine fed the same channel, per topology, with fixed makeup:
+//          every lane of a full interleaved group, and the lone lane of a
+//          partial one, must give what a single lane gives.
+// bands    A linked multiband engine, per topology and link mode, fed one
+//          channel and the same audio 12 dB down on every other: each band
+//          must compress all channels alike, so the quieter ones come out
+//          exactly a quarter of the first (the clipper is off).
+// steps    A step 28 dB over the threshold into one stage, per topology, at
+//          4:1 and 20:1 with attacks from 0.1 to 30 ms: the gain reduction
+//          may not overshoot the static curve by more than 0.1 dB, which
+//          catches a feedback loop that lags its own detector.
+// delays   A burst that has gone into the peak catcher's delay when the
+//          lookahead changes, shorter or longer, at 1 and 5 ms attacks: it
+//          must come out with the gain reduction a stage set to the new
+//          lookahead all along gives it, not lose its place in the detector.
+// kernels  The array FastMath conversions (SSE2 where the build has it)
+//          against the scalar ones bit for bit, with every tail length and
+//          unaligned; the scalar ones and the soft clipper's fast curve
+//          against the exact functions, within the bounds documented in
+//          FastMath.h; and both clipper curves continuous through the knee.
+//
+// A sample passes when it is within --ulp units in the last place of the
+// reference, or when the two differ by less than --floor-db dBFS (near zero
+// ULPs are meaningless). The exit code is 0 when every check passes.
+//==============================================================================
+namespace
+{
+    using TestSignals::Signal;
+    using PresetMode = MixCompressorAudioProcessor::PresetMode;
+
+    constexpr double sampleRate = GoldenRender::sampleRate;
+    constexpr int referenceBlockSize = GoldenRender::blockSize;
+    constexpr int numChannels = GoldenRender::numChannels;
+
+    struct Tolerance
+    {
+        juce::int64 maxUlp = 16;
+        float floorDB = -120.0f;
+    };
+
+    struct Difference
+    {
+        juce::int64 maxUlp = 0;
+        float maxErrorDB = -200.0f;
+        juce::int64 numFailed = 0;
+        juce::int64 firstFailure = -1;
+        bool shapeMismatch = false;
+
+        bool passed() const { return numFailed == 0 && !shapeMismatch; }
+    };
+
+    // Distance between two floats counted in representable values, so it
+    // means the same at every magnitude
+    juce::int64 ulpDistance(float a, float b)
+    {
+        auto ordered = [](float x)
+            {
+                juce::int32 bits;
+                std::memcpy(&bits, &x, sizeof(bits));
+                return bits < 0 ? static_cast<juce::int64>(std::numeric_limits<juce::int32>::min()) - bits
+                                : static_cast<juce::int64>(bits);
+            };
+
+        return std::abs(ordered(a) - ordered(b));
+    }
+
+    Difference compare(const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& reference,
+        const Tolerance& tolerance)
+    {
+        Difference difference;
+
+        if (actual.getNumChannels() != reference.getNumChannels() || actual.getNumSamples() != reference.getNumSamples())
+        {
+            difference.shapeMismatch = true;
+            return difference;
+        }
+
+        auto floorGain = juce::Decibels::decibelsToGain(tolerance.floorDB, -1000.0f);
+
+        for (int channel = 0; channel < actual.getNumChannels(); ++channel)
+        {
+            auto* a = actual.getReadPointer(channel);
+            auto* r = reference.getReadPointer(channel);
+
+            for (int i = 0; i < actual.getNumSamples(); ++i)
+            {
+                auto ulp = ulpDistance(a[i], r[i]);
+                auto error = std::abs(a[i] - r[i]);
+
+                difference.maxUlp = juce::jmax(difference.maxUlp, ulp);
+
+                if (error > 0.0f)
+                    difference.maxErrorDB = juce::jmax(difference.maxErrorDB, juce::Decibels::gainToDecibels(error, -200.0f));
+
+                // NaN fails both tests
+                if (!(ulp <= tolerance.maxUlp || error < floorGain))
+                {
+                    if (difference.numFailed++ == 0)
+                        difference.firstFailure = i;
+                }
+            }
+        }
+
+        return difference;
+    }
+
+    juce::String describe(const Difference& difference)
+    {
+        if (difference.shapeMismatch)
+            return "channel count or length differs";
+
+        auto text = "max " + juce::String(difference.maxUlp) + " ulp, "
+                  + (difference.maxErrorDB > -200.0f ? juce::String(difference.maxErrorDB, 1) + " dB" : juce::String("exact"));
+
+        if (!difference.passed())
+            text << ", " << juce::String(difference.numFailed) << " samples over (first at " << juce::String(difference.firstFailure) << ")";
+
+        return text;
+    }
+
+    //==============================================================================
+    struct Results
+    {
+        int numPassed = 0;
+        int numFailed = 0;
+
+        void report(const juce::String& check, bool passed, const juce::String& detail)
+        {
+            (passed ? numPassed : numFailed)++;
+            std::cout << (passed ? "PASS " : "FAIL ") << check << " | " << detail << std::endl;
+        }
+    };
+
+    void setParameter(MixCompressorAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.getValueTreeState().getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // Renders input through a fresh processor, handing it blocks whose sizes
+    // cycle through blockSizes. The processor is always prepared for the
+    // reference block size, as a host would be.
+    juce::AudioBuffer<float> render(PresetMode preset, const juce::AudioBuffer<float>& input,
+        const std::vector<int>& blockSizes, bool autoMakeup)
+    {
+        MixCompressorAudioProcessor processor;
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::stereo());
+        layout.outputBuses.add(juce::AudioChannelSet::stereo());
+        processor.setBusesLayout(layout);
+
+        processor.loadPreset(preset);
+
+        if (!autoMakeup)
+            setParameter(processor, "autoMakeup", 0.0f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, referenceBlockSize);
+        processor.prepareToPlay(sampleRate, referenceBlockSize);
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+
+        for (int start = 0, b = 0; start < output.getNumSamples(); ++b)
+        {
+            auto numSamples = juce::jmin(blockSizes[static_cast<size_t>(b) % blockSizes.size()], output.getNumSamples() - start);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), output.getNumChannels(), start, numSamples);
+
+            processor.processBlock(block, midi);
+            start += numSamples;
+        }
+
+        return output;
+    }
+
+    //==============================================================================
+    bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate,
+            static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        // The writer owns the stream once it has been created
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        auto stream = file.createInputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatReader> reader(format.createReaderFor(stream.release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return true;
+    }
+
+    //==============================================================================
+    // Every channel of one multichannel engine against its own mono engine
+    bool channelsMatchMonoEngine(MixCompressorDSP::Topology topology, const juce::AudioBuffer<float>& input,
+        const Tolerance& tolerance, juce::String& detail)
+    {
+        constexpr int numEngineChannels = 6; // one full lane group and a partial one
+
+        MixCompressorDSP::Parameters parameters;
+        parameters.threshold1 = -30.0f;
+        parameters.ratio1 = 6.0f;
+        parameters.sidechainSlope1 = MixCompressorDSP::CompressorStage::SidechainSlope::Slope12;
+        parameters.dualStage = true;
+        parameters.sidechainSlope2 = MixCompressorDSP::CompressorStage::SidechainSlope::Slope24;
+        parameters.mixPercent = 70.0f;
+        parameters.topology = topology;
+        parameters.autoMakeup = false; // shared by all channels, from the largest reduction among them
+        parameters.makeupDB = 3.0f;
+        parameters.linkMode = MixCompressorDSP::LinkMode::Unlinked;
+
+        auto lookahead = MixCompressorDSP::CompressorEngine::lookaheadMsToSamples(2.0f, sampleRate);
+
+        // Each channel a different mix of the two input channels, so no two lanes are alike
+        juce::AudioBuffer<float> multichannel(numEngineChannels, input.getNumSamples());
+
+        for (int channel = 0; channel < numEngineChannels; ++channel)
+        {
+            auto weight = static_cast<float>(channel) / static_cast<float>(numEngineChannels - 1);
+            multichannel.copyFrom(channel, 0, input, 0, 0, input.getNumSamples(), 1.0f - weight);
+            multichannel.addFrom(channel, 0, input, 1, 0, input.getNumSamples(), weight);
+        }
+
+        juce::AudioBuffer<float> expected(multichannel);
+
+        for (int channel = 0; channel < numEngineChannels; ++channel)
+        {
+            MixCompressorDSP::CompressorEngine mono;
+            mono.prepare(sampleRate, referenceBlockSize, 1);
+            mono.setParameters(parameters);
+            mono.setLookahead(lookahead);
+            mono.reset();
+
+            auto* data = expected.getWritePointer(channel);
+            mono.process(&data, 1, expected.getNumSamples());
+        }
+
+        MixCompressorDSP::CompressorEngine engine;
+        engine.prepare(sampleRate, referenceBlockSize, numEngineChannels);
+        engine.setParameters(parameters);
+        engine.setLookahead(lookahead);
+        engine.reset();
+        engine.process(multichannel.getArrayOfWritePointers(), numEngineChannels, multichannel.getNumSamples());
+
+        auto difference = compare(multichannel, expected, tolerance);
+        detail = describe(difference);
+        return difference.passed();
+    }
+
+    //==============================================================================
+    // Largest difference, across every channel after the first, from a
+    // quarter of the first channel, through a multiband engine in a linked
+    // mode. Scaling by a power of two is exact, so identical gains give zero.
+    float linkedBandsDeviation(MixCompressorDSP::Topology topology, MixCompressorDSP::LinkMode linkMode,
+        MixCompressorDSP::CrossoverPhase phase, int numEngineChannels, const juce::AudioBuffer<float>& input)
+    {
+        MixCompressorDSP::Parameters parameters;
+        parameters.threshold1 = -30.0f;
+        parameters.ratio1 = 6.0f;
+        parameters.attack1 = 5.0f;
+        parameters.topology = topology;
+        parameters.linkMode = linkMode;
+        parameters.autoMakeup = false;
+        parameters.clipMode = MixCompressorDSP::SoftClipper::Mode::Off;
+
+        juce::AudioBuffer<float> buffer(numEngineChannels, input.getNumSamples());
+
+        for (int channel = 0; channel < numEngineChannels; ++channel)
+            buffer.copyFrom(channel, 0, input, 0, 0, input.getNumSamples(), channel == 0 ? 1.0f : 0.25f);
+
+        MixCompressorDSP::CompressorEngine engine;
+        engine.prepare(sampleRate, referenceBlockSize, numEngineChannels);
+        engine.setCrossover(4, phase);
+        engine.setParameters(parameters);
+        engine.reset();
+
+        for (int start = 0; start < buffer.getNumSamples(); start += referenceBlockSize)
+        {
+            auto numSamples = juce::jmin(referenceBlockSize, buffer.getNumSamples() - start);
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numEngineChannels, start, numSamples);
+            engine.process(block.getArrayOfWritePointers(), numEngineChannels, numSamples);
+        }
+
+        float largest = 0.0f;
+
+        for (int channel = 1; channel < numEngineChannels; ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                largest = juce::jmax(largest, std::abs(buffer.getSample(channel, i) - 0.25f * buffer.getSample(0, i)));
+
+        return largest;
+    }
+
+    void checkLinkedBands(Results& results, const juce::AudioBuffer<float>& input, const char* signalName)
+    {
+        using MixCompressorDSP::CrossoverPhase;
+        using MixCompressorDSP::LinkMode;
+        const char* topologyNames[] = { "vca", "fet", "opto", "varimu" };
+
+        for (int t = 0; t < static_cast<int>(MixCompressorDSP::Topology::NumTopologies); ++t)
+        {
+            for (auto linkMode : { LinkMode::LinkedMax, LinkMode::LinkedAverage })
+            {
+                for (auto phase : { CrossoverPhase::Minimum, CrossoverPhase::Linear })
+                {
+                    for (auto numEngineChannels : { 2, 6 })
+                    {
+                        auto deviation = linkedBandsDeviation(static_cast<MixCompressorDSP::Topology>(t), linkMode, phase,
+                            numEngineChannels, input);
+                        results.report(juce::String("bands ") + topologyNames[t] + "_" + signalName
+                                + (linkMode == LinkMode::LinkedMax ? " max" : " average")
+                                + (phase == CrossoverPhase::Linear ? " linear" : " minimum") + " " + juce::String(numEngineChannels) + "ch",
+                            deviation == 0.0f, "max deviation " + juce::String(deviation, 10));
+                    }
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    // A step from silence to -2 dBFS, 28 dB over a -30 dB threshold, into one
+    // stage. The gain reduction actually applied must never pass what the
+    // static curve gives for that level by more than 0.1 dB on the way in,
+    // and must settle on it.
+    template <typename Topology>
+    void checkStepResponse(Results& results, const char* topologyName)
+    {
+        using MixCompressorDSP::CompressorStage;
+        constexpr int blockFrames = CompressorStage::maxBlockFrames;
+        constexpr int blockSamples = CompressorStage::maxBlockSamples;
+        const auto level = juce::Decibels::decibelsToGain(-2.0f);
+
+        for (auto ratio : { 4.0f, 20.0f })
+        {
+            for (auto attack : { 0.1f, 1.0f, 10.0f, 30.0f })
+            {
+                CompressorStage stage;
+                stage.prepare(sampleRate);
+                stage.setParameters(-30.0f, ratio, attack, 200.0f, 0.0f);
+                stage.reset();
+
+                auto expected = 28.0f * (1.0f - 1.0f / ratio);
+                auto largest = 0.0f, settled = 0.0f;
+                alignas(16) float frames[blockSamples];
+                alignas(16) float gainReduction[blockSamples];
+
+                for (int start = 0; start < static_cast<int>(sampleRate); start += blockFrames)
+                {
+                    std::fill(std::begin(frames), std::end(frames), level);
+                    stage.processBlock<Topology>(frames, gainReduction, blockFrames);
+
+                    for (auto sample : frames)
+                    {
+                        settled = -juce::Decibels::gainToDecibels(sample / level);
+                        largest = juce::jmax(largest, settled);
+                    }
+                }
+
+                auto passed = largest <= expected + 0.1f && std::abs(settled - expected) < 0.1f;
+                results.report(juce::String("step ") + topologyName + " " + juce::String(ratio, 0) + ":1 attack "
+                        + juce::String(attack, 1) + " ms",
+                    passed, "peak " + juce::String(largest, 2) + " dB, settles at " + juce::String(settled, 2)
+                        + " dB, curve " + juce::String(expected, 2) + " dB");
+            }
+        }
+    }
+
+    //==============================================================================
+    // Gain reduction applied to a 16 frame burst at -2 dBFS into a stage with
+    // the given lookahead. With changeTo of zero or more, the lookahead
+    // changes to that at frame 1024, after the burst went in and before it
+    // has come out.
+    float burstGainReduction(int lookahead, int changeTo, float attack)
+    {
+        using MixCompressorDSP::CompressorStage;
+        constexpr int blockFrames = CompressorStage::maxBlockFrames;
+        constexpr int blockSamples = CompressorStage::maxBlockSamples;
+        constexpr int burstStart = 1000, burstEnd = 1016, changeAt = 1024;
+        const auto level = juce::Decibels::decibelsToGain(-2.0f);
+
+        CompressorStage stage;
+        stage.prepare(sampleRate, MixCompressorDSP::CompressorEngine::lookaheadMsToSamples(10.0f, sampleRate));
+        stage.setParameters(-30.0f, 20.0f, attack, 200.0f, 0.0f);
+        stage.setLookahead(lookahead);
+        stage.reset();
+
+        alignas(16) float frames[blockSamples];
+        alignas(16) float gainReduction[blockSamples];
+        float smallest = -1.0f;
+
+        for (int start = 0; start < 4096; start += blockFrames)
+        {
+            static_assert(changeAt % blockFrames == 0, "the change falls between blocks");
+
+            if (start == changeAt && changeTo >= 0)
+                stage.setLookahead(changeTo);
+
+            for (int i = 0; i < blockSamples; ++i)
+            {
+                auto frame = start + i / CompressorStage::numLanes;
+                frames[i] = frame >= burstStart && frame < burstEnd ? level : 0.0f;
+            }
+
+            stage.processBlock(frames, gainReduction, blockFrames);
+
+            // The burst on its way out, at the least reduced frame
+            for (int i = 0; i < blockSamples; i += CompressorStage::numLanes)
+            {
+                if (std::abs(frames[i]) > 0.001f)
+                {
+                    auto reduction = -juce::Decibels::gainToDecibels(std::abs(frames[i]) / level);
+                    smallest = smallest < 0.0f ? reduction : juce::jmin(smallest, reduction);
+                }
+            }
+        }
+
+        return smallest;
+    }
+
+    void checkLookaheadChange(Results& results)
+    {
+        auto toSamples = [](float milliseconds) { return MixCompressorDSP::CompressorEngine::lookaheadMsToSamples(milliseconds, sampleRate); };
+        const std::pair<float, float> changes[] = { { 5.0f, 2.0f }, { 2.0f, 5.0f }, { 5.0f, 0.5f } };
+
+        for (auto attack : { 1.0f, 5.0f })
+        {
+            for (auto& change : changes)
+            {
+                auto changed = burstGainReduction(toSamples(change.first), toSamples(change.second), attack);
+                auto expected = burstGainReduction(toSamples(change.second), -1, attack);
+
+                results.report("delays lookahead " + juce::String(change.first, 1) + " to " + juce::String(change.second, 1) + " ms, attack "
+                        + juce::String(attack, 0) + " ms",
+                    std::abs(changed - expected) < 0.05f,
+                    "burst reduced " + juce::String(changed, 2) + " dB, " + juce::String(expected, 2) + " dB without the change");
+            }
+        }
+    }
+
+    //==============================================================================
+    // Largest deviation of a scalar kernel from a reference over a sweep
+    template <typename Kernel, typename Reference>
+    double maxError(float from, float to, int numPoints, Kernel kernel, Reference reference, bool relative)
+    {
+        double largest = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            auto x = from + (to - from) * static_cast<float>(i) / static_cast<float>(numPoints - 1);
+            auto expected = reference(static_cast<double>(x));
+            auto error = std::abs(static_cast<double>(kernel(x)) - expected);
+            largest = juce::jmax(largest, relative ? error / std::abs(expected) : error);
+        }
+
+        return largest;
+    }
+
+    void checkKernels(Results& results)
+    {
+        using namespace MixCompressorDSP;
+        constexpr int numPoints = 1 << 16;
+
+        // The array versions, four at a time with SSE2 where the build has
+        // it, against the scalar kernels value by value. Every start offset
+        // and tail length, in place for one of them, so the vector body, the
+        // scalar tail and unaligned access all get compared.
+        std::vector<float> decibels(numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+            decibels[static_cast<size_t>(i)] = -120.0f + 144.0f * static_cast<float>(i) / static_cast<float>(numPoints - 1);
+
+        juce::int64 arrayUlp = 0;
+
+        for (int start = 0; start < 4; ++start)
+        {
+            for (int tail = 0; tail < 4; ++tail)
+            {
+                auto numValues = numPoints - start - tail;
+                auto gains = decibels;
+                FastMath::decibelsToGain(gains.data() + start, gains.data() + start, numValues);
+
+                std::vector<float> viaArray(static_cast<size_t>(numPoints));
+                FastMath::gainToDecibels(gains.data() + start, viaArray.data() + start, numValues);
+
+                for (int i = start; i < start + numValues; ++i)
+                {
+                    auto index = static_cast<size_t>(i);
+                    arrayUlp = juce::jmax(arrayUlp, ulpDistance(gains[index], FastMath::decibelsToGain(decibels[index])),
+                        ulpDistance(viaArray[index], FastMath::gainToDecibels(gains[index])));
+                }
+            }
+        }
+
+        results.report(MIXCOMP_FAST_DB_MATH && MIXCOMP_FASTMATH_SSE2 ? "kernels: SSE2 array vs scalar dB conversions"
+                                                                     : "kernels: array (plain loop) vs scalar dB conversions",
+            arrayUlp == 0, "max " + juce::String(arrayUlp) + " ulp");
+
+        // Scalar kernels against the exact functions
+        auto toDecibelsError = maxError(1.0e-6f, 15.85f, numPoints, [](float x) { return FastMath::gainToDecibels(x); },
+            [](double x) { return 20.0 * std::log10(x); }, false);
+        results.report("kernels: gainToDecibels vs std::log10", toDecibelsError < 1.2e-5,
+            juce::String(toDecibelsError, 8) + " dB (bound 1.2e-5)");
+
+        auto toGainError = maxError(-120.0f, 24.0f, numPoints, [](float x) { return FastMath::decibelsToGain(x); },
+            [](double x) { return std::pow(10.0, x / 20.0); }, true);
+        results.report("kernels: decibelsToGain vs std::pow", toGainError < 4.0e-6,
+            juce::String(toGainError, 8) + " relative (bound 4e-6)");
+
+        auto tanhError = maxError(-8.0f, 8.0f, numPoints, [](float x) { return FastMath::tanh(x); },
+            [](double x) { return std::tanh(x); }, false);
+        results.report("kernels: tanh vs std::tanh", tanhError < 1.1e-4, juce::String(tanhError, 8) + " (bound 1.1e-4)");
+
+        // The clipper's fast mode against its exact curve, over a whole buffer
+        // so the vectorized loop is what gets measured
+        std::vector<float> clipped(numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+            clipped[static_cast<size_t>(i)] = -4.0f + 8.0f * static_cast<float>(i) / static_cast<float>(numPoints - 1);
+
+        auto inputs = clipped;
+        SoftClipper clipper;
+        clipper.prepare(1);
+        clipper.setMode(SoftClipper::Mode::Fast);
+        clipper.process(clipped.data(), 0, numPoints);
+
+        double clipError = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+            clipError = juce::jmax(clipError, static_cast<double>(std::abs(clipped[static_cast<size_t>(i)] - SoftClipper::clip(inputs[static_cast<size_t>(i)]))));
+
+        // tanh's bound scaled by 1 / drive
+        results.report("kernels: fast soft clip vs exact curve", clipError < 1.25e-4, juce::String(clipError, 8) + " (bound 1.25e-4)");
+
+        // A step in either curve shows up as a second difference far larger
+        // than the curve's bend over one point (under 1e-6 here); a step at
+        // the knee as big as tanh's shortfall there would be 5.8e-5
+        double largestBend = 0.0;
+
+        for (int i = 1; i + 1 < numPoints; ++i)
+        {
+            auto at = [&](int index) { return static_cast<double>(inputs[static_cast<size_t>(index)]); };
+            auto exactBend = SoftClipper::clip(at(i + 1)) - 2.0 * SoftClipper::clip(at(i)) + SoftClipper::clip(at(i - 1));
+            auto fastBend = static_cast<double>(clipped[static_cast<size_t>(i + 1)]) - 2.0 * clipped[static_cast<size_t>(i)]
+                + clipped[static_cast<size_t>(i - 1)];
+            largestBend = juce::jmax(largestBend, std::abs(exactBend), std::abs(fastBend));
+        }
+
+        results.report("kernels: soft clip continuous", largestBend < 5.0e-6, juce::String(largestBend, 10) + " (bound 5e-6)");
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: MixCompressorRegression <reference dir> [--update] [--ulp <n>] [--floor-db <dB>] [--seconds <s>]"
+                  << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::File referenceDirectory;
+    bool update = false;
+    double seconds = 4.0;
+    Tolerance tolerance;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(argv[i]);
+
+        if (arg == "--update")
+            update = true;
+        else if (arg == "--ulp" && i + 1 < argc)
+            tolerance.maxUlp = juce::jmax<juce::int64>(0, juce::String(argv[++i]).getLargeIntValue());
+        else if (arg == "--floor-db" && i + 1 < argc)
+            tolerance.floorDB = juce::String(argv[++i]).getFloatValue();
+        else if (arg == "--seconds" && i + 1 < argc)
+            seconds = juce::String(argv[++i]).getDoubleValue();
+        else if (!arg.startsWith("--") && referenceDirectory == juce::File())
+            referenceDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (referenceDirectory == juce::File())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (update && !referenceDirectory.createDirectory())
+    {
+        std::cerr << "Can't create " << referenceDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const PresetMode presets[] = { PresetMode::VocalLeveler, PresetMode::DrumPunch, PresetMode::BassControl,
+                                   PresetMode::MixBusGlue, PresetMode::ParallelComp };
+    const Signal signals[] = { Signal::Sine, Signal::PinkNoise, Signal::Transients };
+
+    // Splits to compare against the reference block size; the last one is
+    // larger than the processor was prepared for
+    const std::vector<int> splits[] = { { 1 }, { 37 }, { 64 }, { 1, 511, 7, 300, 64, 129, 2 }, { 4096 } };
+
+    auto numSamples = juce::jmax(referenceBlockSize, static_cast<int>(sampleRate * seconds));
+    juce::AudioBuffer<float> input(numChannels, numSamples);
+    Results results;
+
+    for (auto signal : signals)
+    {
+        TestSignals::generateSignal(signal, input, sampleRate);
+
+        juce::AudioBuffer<float> goldenInput(numChannels, GoldenRender::numSamples);
+        TestSignals::generateSignal(signal, goldenInput, sampleRate);
+
+        for (auto preset : presets)
+        {
+            auto presetIndex = static_cast<int>(preset);
+            auto name = juce::String(GoldenRender::getPresetName(presetIndex)) + "_" + TestSignals::getSignalName(signal);
+
+            // Golden output
+            std::vector<std::vector<float>> goldenChannels;
+
+            if (!GoldenRender::render(presetIndex, signal, goldenChannels))
+            {
+                results.report("golden " + name, false, "the preset sets a parameter GoldenRender::applyValue doesn't know");
+                continue;
+            }
+
+            float* goldenPointers[numChannels];
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                goldenPointers[channel] = goldenChannels[static_cast<size_t>(channel)].data();
+
+            juce::AudioBuffer<float> golden(goldenPointers, numChannels, GoldenRender::numSamples);
+            auto file = referenceDirectory.getChildFile(name + ".wav");
+
+            if (update)
+            {
+                auto written = writeReference(file, golden);
+                results.report("golden " + name, written, written ? "reference written" : "can't write " + file.getFullPathName());
+            }
+            else
+            {
+                juce::AudioBuffer<float> reference;
+
+                if (readReference(file, reference))
+                {
+                    auto difference = compare(golden, reference, tolerance);
+                    results.report("golden " + name, difference.passed(), describe(difference));
+                }
+                else
+                {
+                    results.report("golden " + name, false, "missing reference " + file.getFullPathName()
+                        + " (record it with --update on a known-good build)");
+                }
+            }
+
+            // The plugin against the same render
+            auto wrapperDifference = compare(render(preset, goldenInput, { referenceBlockSize }, true), golden, tolerance);
+            results.report("wrapper " + name, wrapperDifference.passed(), describe(wrapperDifference));
+
+            // Block splits
+            auto unsplit = render(preset, input, { referenceBlockSize }, false);
+
+            for (auto& split : splits)
+            {
+                juce::StringArray sizes;
+                for (auto size : split)
+                    sizes.add(juce::String(size));
+
+                auto difference = compare(render(preset, input, split, false), unsplit, tolerance);
+                results.report("split " + name + " [" + sizes.joinIntoString(",") + "]", difference.passed(), describe(difference));
+            }
+        }
+
+        // Lanes
+        const char* topologyNames[] = { "vca", "fet", "opto", "varimu" };
+
+        for (int t = 0; t < static_cast<int>(MixCompressorDSP::Topology::NumTopologies); ++t)
+        {
+            juce::String detail;
+            auto passed = channelsMatchMonoEngine(static_cast<MixCompressorDSP::Topology>(t), input, tolerance, detail);
+            results.report(juce::String("lanes ") + topologyNames[t] + "_" + TestSignals::getSignalName(signal), passed, detail);
+        }
+
+        checkLinkedBands(results, input, TestSignals::getSignalName(signal));
+    }
+
+    checkStepResponse<MixCompressorDSP::Topologies::VCA>(results, "vca");
+    checkStepResponse<MixCompressorDSP::Topologies::FET>(results, "fet");
+    checkStepResponse<MixCompressorDSP::Topologies::Opto>(results, "opto");
+    checkStepResponse<MixCompressorDSP::Topologies::VariMu>(results, "varimu");
+    checkLookaheadChange(results);
+    checkKernels(results);
+
+    std::cout << results.numPassed << " passed, " << results.numFailed << " failed" << std::endl;
+    return results.numFailed == 0 ? 0 : 1;
+}